@@ -1,4 +1,5 @@
 #include "yy_test_utils.h"
+#include "yy_thread.h"
 
 
 /**
@@ -8,10 +9,12 @@
  
  @param json JSON data in UTF-8 with null-terminator.
  @param size JSON data size in bytes.
+ @param valid Whether the JSON was parsed successfully, the ticks of a tiny
+    input may be 0 on a coarse timer.
  @param repeat Loop count for meansure.
- @return The ticks cost of one loop.
+ @return The ticks cost of one loop, or 0 if failed.
  */
-typedef u64 (*reader_measure_func)(const char *json, size_t size, int repeat);
+typedef u64 (*reader_measure_func)(const char *json, size_t size, bool *valid, int repeat);
 
 
 /**
@@ -31,6 +34,22 @@ typedef u64 (*writer_measure_func)(const char *json, size_t size, size_t *out_si
                                    bool *roundtrip, bool pretty, int repeat);
 
 
+/**
+ Function prototype to meansure a JSON read and write (minify) roundtrip.
+ A wrapper should define the function with this format: roundtrip_measure_<name>.
+ For example: roundtrip_measure_yyjson.
+ 
+ @param json JSON data in UTF-8 with null-terminator, should be minified.
+ @param size JSON data size in bytes.
+ @param out_size JSON output size in bytes.
+ @param roundtrip JSON output same as input in every loop.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop (read and write), or 0 if failed.
+ */
+typedef u64 (*roundtrip_measure_func)(const char *json, size_t size, size_t *out_size,
+                                      bool *roundtrip, int repeat);
+
+
 typedef struct {
     int num_null;
     int num_true;
@@ -55,6 +74,1079 @@ typedef struct {
 typedef u64 (*stats_measure_func)(const char *json, size_t size, stats_data *data, int repeat);
 
 
+/** An object in the document and the keys to lookup in it. */
+typedef struct {
+    usize depth;            /* path length from root to the object */
+    const char **path;      /* path from root: object keys or array indexes (decimal) */
+    usize width;            /* member count of the object */
+    usize key_count;        /* key count to lookup */
+    const char **keys;      /* keys to lookup, null-terminated */
+    const usize *key_lens;  /* key lengths */
+} lookup_target;
+
+/**
+ Function prototype to meansure the performance of object lookup by key.
+ A wrapper should define the function with this format: lookup_measure_<name>.
+ For example: lookup_measure_yyjson.
+ 
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param targets The objects and keys to lookup, the objects should be located
+    by path before meansure.
+ @param target_count Target count.
+ @param found Count of keys found in one loop.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop (all keys of all targets), or 0 if failed.
+ */
+typedef u64 (*lookup_measure_func)(const char *json, size_t size,
+                                   const lookup_target *targets, usize target_count,
+                                   usize *found, int repeat);
+
+
+/** A JSON Pointer reference token, unescaped and null-terminated. */
+typedef struct {
+    const char *str;
+    usize len;
+} json_ptr_token;
+
+/** JSON Pointers for pointer benchmark. */
+typedef struct {
+    usize count;                         /* pointer count */
+    const char **ptrs;                   /* pointer strings, null-terminated */
+    const usize *lens;                   /* pointer string lengths */
+    const json_ptr_token **tokens;       /* parsed tokens of each pointer */
+    const usize *token_counts;           /* token count of each pointer */
+} pointer_data;
+
+/**
+ Function prototype to meansure the performance of JSON Pointer resolution.
+ A wrapper should define the function with this format: pointer_measure_<name>.
+ For example: pointer_measure_yyjson.
+ 
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param data The pointers to resolve, all of them exist in the document.
+ @param walk_only Resolve with the parsed tokens (only walk the tree), or
+    resolve with the pointer strings (parse the pointer and walk the tree).
+ @param found Count of values found in one loop.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop (all pointers), or 0 if failed.
+ */
+typedef u64 (*pointer_measure_func)(const char *json, size_t size, const pointer_data *data,
+                                    bool walk_only, usize *found, int repeat);
+
+
+/** Value type for JSONPath evaluation. */
+typedef enum {
+    JSON_PATH_NONE,
+    JSON_PATH_NULL,
+    JSON_PATH_BOOL,
+    JSON_PATH_NUM,
+    JSON_PATH_STR,
+    JSON_PATH_ARR,
+    JSON_PATH_OBJ
+} json_path_type;
+
+/** Step type of a compiled JSONPath. */
+typedef enum {
+    JSON_PATH_STEP_NAME,        /* .name or ['name'] */
+    JSON_PATH_STEP_WILDCARD,    /* .* or [*] */
+    JSON_PATH_STEP_INDEX,       /* [n] */
+    JSON_PATH_STEP_SLICE,       /* [start:end:step] */
+    JSON_PATH_STEP_FILTER       /* [?(@.name op literal)] */
+} json_path_step_type;
+
+/** Operator of a JSONPath filter. */
+typedef enum {
+    JSON_PATH_OP_EXISTS,
+    JSON_PATH_OP_EQ,
+    JSON_PATH_OP_NE,
+    JSON_PATH_OP_LT,
+    JSON_PATH_OP_LE,
+    JSON_PATH_OP_GT,
+    JSON_PATH_OP_GE
+} json_path_op;
+
+/** A step of a compiled JSONPath, the strings are null-terminated. */
+typedef struct {
+    json_path_step_type type;
+    bool descendant;            /* preceded by `..` */
+    const char *name;           /* member name, or filter member of `@` (NULL for `@`) */
+    usize name_len;
+    i64 start, end, step;       /* index in `start`, or slice range */
+    bool has_start, has_end;    /* slice bounds present */
+    json_path_op op;            /* filter operator */
+    json_path_type lit_type;    /* filter literal type: null, bool, number or string */
+    const char *lit_str;
+    usize lit_len;
+    f64 lit_num;
+    bool lit_bool;
+} json_path_step;
+
+/** A compiled JSONPath (see json_path.c). */
+typedef struct {
+    usize count;                /* step count */
+    json_path_step *steps;      /* steps */
+    char *str;                  /* copy of the path string */
+} json_path;
+
+/** A value handle for JSONPath evaluation, the content is defined by adapter. */
+typedef struct {
+    const void *ptr;
+    usize aux;
+} json_path_val;
+
+/** Callback for adapter iteration, `key` is NULL for array element. */
+typedef void (*json_path_each_func)(void *ctx, const char *key, usize key_len,
+                                    json_path_val val);
+
+/** Read-only DOM access used by the JSONPath engine, one for each library.
+    The key passed to `obj_get` is always null-terminated. */
+typedef struct {
+    json_path_type (*get_type)(json_path_val val);
+    bool (*get_bool)(json_path_val val);
+    f64 (*get_num)(json_path_val val);
+    const char *(*get_str)(json_path_val val, usize *len);
+    usize (*arr_size)(json_path_val val);
+    bool (*arr_get)(json_path_val val, usize idx, json_path_val *out);
+    bool (*obj_get)(json_path_val val, const char *key, usize key_len, json_path_val *out);
+    void (*foreach)(json_path_val val, json_path_each_func func, void *ctx);
+} json_path_adapter;
+
+/**
+ Function prototype to meansure the performance of JSONPath query.
+ A wrapper should define the function with this format: path_measure_<name>.
+ For example: path_measure_yyjson.
+ 
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param path The compiled JSONPath.
+ @param with_parse Measure parse and query together, or query an already
+    parsed document only.
+ @param found Count of values matched in one loop.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if not supported or failed.
+ */
+typedef u64 (*path_measure_func)(const char *json, size_t size, const json_path *path,
+                                 bool with_parse, usize *found, int repeat);
+
+
+/**
+ Function prototype to meansure the performance of random array index access.
+ A wrapper should define the function with this format: index_measure_<name>.
+ For example: index_measure_yyjson.
+ 
+ @param json JSON data in UTF-8 with null-terminator, the root should be an array.
+ @param size JSON data size in bytes.
+ @param idxs The indexes to access, all of them are less than the array length.
+ @param idx_count Index count.
+ @param found Count of values accessed in one loop.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop (all indexes), or 0 if failed.
+ */
+typedef u64 (*index_measure_func)(const char *json, size_t size, const usize *idxs,
+                                  usize idx_count, usize *found, int repeat);
+
+
+/**
+ Function prototype to meansure the performance of document mutation.
+ A wrapper should define the function with this format: mutate_measure_<name>.
+ For example: mutate_measure_yyjson.
+ 
+ The document is parsed before each loop, then mutated in post-order (the
+ children before their container, new values are not visited), one op for:
+    - number: add 1 (integer stays integer); bool: negate.
+    - array of n elements: append integer n; if n >= 2, splice: remove
+      elements [n/4, n/2) and insert string "spliced" at index 0.
+    - object of n members: if n >= 1, replace the last value with integer n;
+      if n >= 3, remove member n/2; if n >= 1, rename the first key to
+      "_" + key (the key is truncated to 254 bytes); insert "_id": n.
+ Strings and nulls are not changed.
+ 
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param write Meansure the mutation, or meansure writing (minify) the
+    mutated document.
+ @param ops Count of mutation ops in one loop.
+ @param out_size Output size of the mutated document in bytes.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop (mutation or write), or 0 if failed.
+ */
+typedef u64 (*mutate_measure_func)(const char *json, size_t size, bool write,
+                                   usize *ops, size_t *out_size, int repeat);
+
+
+/** Callback for patch adapter iteration, returns false to stop. */
+typedef bool (*json_patch_each_func)(void *ctx, const char *key, usize key_len, void *val);
+
+/**
+ Mutable DOM access used by the shared JSON Patch implementation (see json_patch.c).
+ A value is a library value pointer. A detached value is not in any container,
+ it is owned by the caller until it is inserted or released. The keys passed to
+ the adapter are always null-terminated.
+ */
+typedef struct {
+    void *ctx;                                                  /* document or allocator */
+    json_path_type (*get_type)(void *val);
+    bool (*get_bool)(void *val);
+    f64 (*get_num)(void *val);
+    const char *(*get_str)(void *val, usize *len);
+    usize (*size)(void *ctn);                                   /* array or object size */
+    void *(*arr_get)(void *arr, usize idx);
+    void *(*obj_get)(void *obj, const char *key, usize key_len);
+    bool (*obj_foreach)(void *obj, json_patch_each_func func, void *each_ctx);
+    void *(*dup)(void *ctx, void *val);                         /* detached deep copy */
+    void *(*new_obj)(void *ctx);                                /* detached empty object */
+    void (*release)(void *ctx, void *val);                      /* release a detached value */
+    bool (*obj_put)(void *ctx, void *obj, const char *key, usize key_len,
+                    void *val);                                 /* owns val on success */
+    void *(*obj_remove)(void *ctx, void *obj, const char *key, usize key_len);
+    bool (*arr_insert)(void *ctx, void *arr, usize idx,
+                       void *val);                              /* owns val on success */
+    void *(*arr_remove)(void *ctx, void *arr, usize idx);
+} json_patch_adapter;
+
+/**
+ Function prototype to meansure the performance of applying a patch.
+ A wrapper should define the function with this format: patch_measure_<name>.
+ For example: patch_measure_yyjson.
+ 
+ Each loop produces a patched document from the original one. A library which
+ patches in place copies the document first, the copy is included in the cost.
+ 
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param patch Patch document, parsed before meansure.
+ @param patch_size Patch document size in bytes.
+ @param merge The patch is JSON Merge Patch (RFC 7386), or JSON Patch (RFC 6902).
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if failed.
+ */
+typedef u64 (*patch_measure_func)(const char *json, size_t size, const char *patch,
+                                  size_t patch_size, bool merge, int repeat);
+
+
+/** A string of the native data, null-terminated, `str` is NULL for JSON null. */
+typedef struct {
+    const char *str;
+    usize len;
+} build_str;
+
+/** twitter.json: statuses[].entities.hashtags[] */
+typedef struct {
+    build_str text;
+    u64 indices[2];
+} build_hashtag;
+
+/** twitter.json: statuses[].entities.user_mentions[] */
+typedef struct {
+    build_str screen_name;
+    build_str name;
+    u64 id;
+    build_str id_str;
+    u64 indices[2];
+} build_mention;
+
+/** twitter.json: statuses[].user */
+typedef struct {
+    u64 id;
+    build_str id_str;
+    build_str name;
+    build_str screen_name;
+    build_str location;
+    build_str description;
+    bool is_protected;
+    u64 followers_count;
+    u64 friends_count;
+    u64 listed_count;
+    build_str created_at;
+    u64 favourites_count;
+    bool verified;
+    u64 statuses_count;
+    build_str lang;
+    build_str profile_image_url;
+} build_user;
+
+/** twitter.json: statuses[] */
+typedef struct {
+    build_str created_at;
+    u64 id;
+    build_str id_str;
+    build_str text;
+    build_str source;
+    bool truncated;
+    u64 in_reply_to_status_id;          /* 0 for null */
+    build_str in_reply_to_status_id_str;
+    u64 in_reply_to_user_id;            /* 0 for null */
+    build_str in_reply_to_user_id_str;
+    build_str in_reply_to_screen_name;
+    build_user user;
+    u64 retweet_count;
+    u64 favorite_count;
+    usize hashtag_count;
+    const build_hashtag *hashtags;
+    usize mention_count;
+    const build_mention *mentions;
+    bool favorited;
+    bool retweeted;
+    build_str lang;
+} build_status;
+
+/** twitter.json */
+typedef struct {
+    usize status_count;
+    const build_status *statuses;
+    f64 completed_in;                   /* search_metadata */
+    u64 max_id;
+    build_str max_id_str;
+    build_str next_results;
+    build_str query;
+    build_str refresh_url;
+    u64 count;
+    u64 since_id;
+    build_str since_id_str;
+} build_twitter;
+
+/** citm_catalog.json: a member of the name maps (areaNames, venueNames...) */
+typedef struct {
+    build_str key;
+    build_str name;
+} build_name;
+
+typedef struct {
+    build_str name;                     /* member name in root, e.g. "areaNames" */
+    usize count;
+    const build_name *names;
+} build_name_map;
+
+/** citm_catalog.json: events.<id> */
+typedef struct {
+    build_str key;                      /* the id as decimal string */
+    u64 id;
+    build_str logo;
+    build_str name;
+    usize sub_topic_count;
+    const u64 *sub_topic_ids;
+    usize topic_count;
+    const u64 *topic_ids;
+} build_event;
+
+/** citm_catalog.json: performances[].prices[] */
+typedef struct {
+    u64 amount;
+    u64 audience_sub_category_id;
+    u64 seat_category_id;
+} build_price;
+
+/** citm_catalog.json: performances[].seatCategories[] */
+typedef struct {
+    usize area_count;
+    const u64 *area_ids;                /* areas[].areaId, blockIds is always empty */
+    u64 seat_category_id;
+} build_seat_category;
+
+/** citm_catalog.json: performances[] */
+typedef struct {
+    u64 event_id;
+    u64 id;
+    build_str logo;
+    usize price_count;
+    const build_price *prices;
+    usize seat_category_count;
+    const build_seat_category *seat_categories;
+    u64 start;
+    build_str venue_code;
+} build_performance;
+
+/** citm_catalog.json (topicSubTopics is not included) */
+typedef struct {
+    usize event_count;
+    const build_event *events;
+    usize performance_count;
+    const build_performance *performances;
+    usize map_count;
+    const build_name_map *maps;
+} build_citm;
+
+/** Native data for DOM builder benchmark, one of the documents is not NULL. */
+typedef struct {
+    const build_twitter *twitter;
+    const build_citm *citm;
+    void *owner;                        /* owner of the strings and arrays */
+} build_data;
+
+/**
+ Function prototype to meansure the performance of building a document from
+ native data. A wrapper should define the function with this format:
+ build_measure_<name>. For example: build_measure_yyjson.
+ 
+ The document is built with the members in the order of the struct fields,
+ the null fields of the source file are written as null.
+ 
+ @param data The native data.
+ @param copy Copy the strings (values and the keys from data) into the document,
+    or borrow them from `data`. The literal keys are borrowed if the library
+    supports it in this mode.
+ @param write Write the document (minify) after build.
+ @param out_size JSON output size in bytes if `write` is true.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if not supported or failed.
+ */
+typedef u64 (*build_measure_func)(const build_data *data, bool copy, bool write,
+                                  size_t *out_size, int repeat);
+
+
+/**
+ Function prototype to meansure the performance of writing JSON straight from
+ native data, without an intermediate document.
+ A wrapper should define the function with this format: stream_measure_<name>.
+ For example: stream_measure_rapidjson.
+ 
+ The output is minified, with the same members as `build_measure_func`.
+ 
+ @param data The native data.
+ @param out Output JSON of the last loop, should be released with free().
+ @param out_size Output JSON size in bytes.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if not supported or failed.
+ */
+typedef u64 (*stream_measure_func)(const build_data *data, char **out,
+                                   size_t *out_size, int repeat);
+
+/**
+ Function prototype to meansure the performance of reading JSON without
+ building a document (SAX), the values are counted in one pass over the input.
+ A wrapper should define the function with this format: sax_measure_<name>.
+ For example: sax_measure_rapidjson.
+
+ The result should be same as `stats_measure_func`, object keys are counted
+ as strings. A library without event API may parse into a reused memory pool
+ and iterate the values inside the timing.
+
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param data JSON stats data output.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if failed.
+ */
+typedef u64 (*sax_measure_func)(const char *json, size_t size, stats_data *data, int repeat);
+
+/**
+ Function prototype to meansure a reference kernel which makes one pass over
+ the input (such as memcpy), shown as the bandwidth ceiling of the readers
+ and writers. A kernel should define the function with this format:
+ roofline_measure_<name>. For example: roofline_measure_memcpy.
+ 
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if failed.
+ */
+typedef u64 (*roofline_measure_func)(const char *json, size_t size, int repeat);
+
+/**
+ Function prototype to meansure the cost of UTF-8 validation while parsing.
+ A wrapper should define the function with this format: utf8_measure_<name>.
+ For example: utf8_measure_yyjson. The document is parsed and released, with
+ the encoding validation of the library turned on or off.
+ 
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param validate Validate the encoding while parsing.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if failed or the library cannot
+    turn off (or turn on) the validation.
+ */
+typedef u64 (*utf8_measure_func)(const char *json, size_t size, bool validate, int repeat);
+
+/** Escape style of the string writer. */
+typedef enum {
+    STRING_ESCAPE_DEFAULT,  /* only quote, backslash and control characters */
+    STRING_ESCAPE_UNICODE,  /* also non-ASCII as \uXXXX (surrogate pairs) */
+    STRING_ESCAPE_SLASHES,  /* also '/' as \/ */
+    STRING_ESCAPE_NUM
+} string_escape;
+
+/**
+ Function prototype to meansure the performance of string unescaping.
+ A wrapper should define the function with this format: string_reader_measure_<name>.
+ For example: string_reader_measure_yyjson. The input is an array of strings,
+ every string should be decoded inside the timing (a lazy reader should get
+ each string).
+ 
+ @param json JSON data in UTF-8 with null-terminator, an array of strings.
+ @param size JSON data size in bytes.
+ @param len Output total length of the decoded strings in bytes.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if failed.
+ */
+typedef u64 (*string_reader_measure_func)(const char *json, size_t size, usize *len, int repeat);
+
+/**
+ Function prototype to meansure the performance of string escaping.
+ A wrapper should define the function with this format: string_writer_measure_<name>.
+ For example: string_writer_measure_yyjson. The input is parsed before, only
+ the minified writing is measured.
+ 
+ @param json JSON data in UTF-8 with null-terminator, an array of strings.
+ @param size JSON data size in bytes.
+ @param esc Escape style of the output.
+ @param out_size Output JSON size in bytes.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if the escape style is not
+    supported or failed.
+ */
+typedef u64 (*string_writer_measure_func)(const char *json, size_t size, string_escape esc,
+                                          size_t *out_size, int repeat);
+
+/**
+ Function prototype to meansure a JSON reader on documents dominated by long
+ strings (blobs). A wrapper should define the function with this format:
+ blob_measure_<name>. For example: blob_measure_yyjson.
+ 
+ In-situ mode parses a mutable copy of the input (copied outside the timing),
+ the strings may point into the copy; otherwise the strings are copied into
+ the document.
+ 
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param insitu Parse in-situ.
+ @param mem Output memory held by the document in bytes (exclude the input
+    copy of in-situ mode), or 0 if the library cannot report it.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if the mode is not supported or failed.
+ */
+typedef u64 (*blob_measure_func)(const char *json, size_t size, bool insitu,
+                                 usize *mem, int repeat);
+
+/** How the inner document of a nested (double-encoded) message is handed over. */
+typedef enum {
+    NESTED_COPY,        /* the decoded payload is copied out, then parsed */
+    NESTED_ZERO_COPY,   /* the decoded payload is parsed where the outer doc holds it */
+    NESTED_INSITU,      /* the outer doc is parsed in-situ, the payload is parsed
+                           in place (in-situ too if the library supports it) */
+    NESTED_MODE_NUM
+} nested_mode;
+
+/**
+ Function prototype to meansure a pipeline on nested JSON: parse the outer
+ document, get the unescaped string of each message's "payload" member, and
+ parse it as JSON. A wrapper should define the function with this format:
+ nested_measure_<name>. For example: nested_measure_yyjson.
+ 
+ @param json JSON data in UTF-8 with null-terminator, an array of objects
+    with a string member "payload" (see `benchmark_gen_nested()`).
+ @param size JSON data size in bytes.
+ @param mode How the payload is handed over to the inner parse.
+ @param count Output count of the inner documents parsed.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop (end-to-end), or 0 if the mode is not
+    supported or failed.
+ */
+typedef u64 (*nested_measure_func)(const char *json, size_t size, nested_mode mode,
+                                   usize *count, int repeat);
+
+
+/** Number literals for number benchmark. */
+typedef struct {
+    usize count;        /* number count */
+    const char **strs;  /* number literals, each one is null-terminated and
+                           followed by at least 64 bytes zero padding */
+    const usize *lens;  /* number literal length */
+    const char *array;  /* all the numbers as a JSON array: [n1,n2,...] */
+    usize array_size;   /* array length in bytes */
+} number_data;
+
+/**
+ Function prototype to meansure the performance of number parsing.
+ A wrapper should define the function with this format: number_reader_measure_<name>.
+ For example: number_reader_measure_yyjson.
+ 
+ @param data The number literals.
+ @param vals Output values as double, NaN if the number cannot be parsed.
+ @param single Parse each number as a single-value document, or parse the array.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if not supported or failed.
+ */
+typedef u64 (*number_reader_measure_func)(const number_data *data, f64 *vals,
+                                          bool single, int repeat);
+
+
+/** Number values for number writer benchmark. */
+typedef struct {
+    usize count;        /* number count */
+    bool is_int;        /* values are in `ints` or `reals` */
+    const i64 *ints;    /* integer values */
+    const f64 *reals;   /* real values, all finite */
+} number_values;
+
+/**
+ Function prototype to meansure the performance of number serialization.
+ A wrapper should define the function with this format: number_writer_measure_<name>.
+ For example: number_writer_measure_yyjson.
+ 
+ @param vals The number values, should be written as a minified JSON array.
+ @param out Output JSON of the last loop, should be released with free().
+ @param out_size Output JSON size in bytes.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if not supported or failed.
+ */
+typedef u64 (*number_writer_measure_func)(const number_values *vals, char **out,
+                                          usize *out_size, int repeat);
+
+
+/**
+ Function prototype to meansure a parallel JSON reader performance.
+ A wrapper should define the function with this format: parallel_reader_measure_<name>.
+ For example: parallel_reader_measure_yyjson.
+ 
+ @param json JSON data in UTF-8 with null-terminator, the root should be an array.
+ @param size JSON data size in bytes.
+ @param thread_count Thread count to parse with, 1 means a serial parse.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop.
+ */
+typedef u64 (*parallel_reader_measure_func)(const char *json, size_t size,
+                                            int thread_count, int repeat);
+
+
+/**
+ Function prototype to meansure a parallel JSON writer performance (minify).
+ A wrapper should define the function with this format: parallel_writer_measure_<name>.
+ For example: parallel_writer_measure_yyjson.
+ 
+ @param json JSON data in UTF-8 with null-terminator, the root should be a container.
+ @param size JSON data size in bytes.
+ @param out_size JSON output size in bytes.
+ @param thread_count Thread count to write with, 1 means a serial write.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if the output is not same as the serial writer.
+ */
+typedef u64 (*parallel_writer_measure_func)(const char *json, size_t size, size_t *out_size,
+                                            int thread_count, int repeat);
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ Split a large JSON array into segments for parallel parsing.
+ The chunks are scanned on the thread pool speculatively (see json_split.c).
+ 
+ @param json JSON data, the root should be an array.
+ @param size JSON data size in bytes.
+ @param splits Output split offsets, should have at least `count + 1` slots.
+    splits[0] is the root '[', splits[n] is the root ']', others are top-level
+    ','. Segment i is the text between splits[i] and splits[i + 1] (exclusive).
+ @param count Max segment count.
+ @param pool Thread pool for scanning.
+ @return Segment count, or 0 if the root is not a well-formed array.
+ */
+int json_array_split(const char *json, usize size, usize *splits,
+                     int count, yy_thread_pool *pool);
+
+/** A serialized segment of a container: the members without brackets. */
+typedef struct {
+    const char *str;
+    usize len;
+} json_segment;
+
+/** Returns the buffer size to join the segments (include null-terminator). */
+usize json_segments_join_size(const json_segment *segs, int count);
+
+/**
+ Join serialized segments into one container, separated with ','.
+ The segments are copied to the output on the thread pool, the first segment
+ may be written at `dst + 1` already and is not copied then.
+ 
+ @param segs Segments in order, may be empty.
+ @param count Segment count.
+ @param is_obj Wrap the output with '{}' or '[]'.
+ @param dst Output buffer, should be at least `json_segments_join_size()`.
+ @param pool Thread pool for copying.
+ @return The output length (exclude null-terminator).
+ */
+usize json_segments_join(const json_segment *segs, int count, bool is_obj,
+                         char *dst, yy_thread_pool *pool);
+
+/** Instruction set of the structural index scanner (see json_scan.c). */
+typedef enum {
+    JSON_SCAN_SCALAR,
+    JSON_SCAN_SSE2,
+    JSON_SCAN_AVX2,
+    JSON_SCAN_AVX512,   /* AVX-512 F and BW */
+    JSON_SCAN_NEON,     /* AArch64 only */
+    JSON_SCAN_ISA_NUM
+} json_scan_isa;
+
+/** Returns the name of the instruction set, such as "avx2". */
+const char *json_scan_isa_name(json_scan_isa isa);
+
+/** Whether the instruction set is supported by the build and the running CPU. */
+bool json_scan_supported(json_scan_isa isa);
+
+/** Returns the best supported instruction set (runtime dispatch). */
+json_scan_isa json_scan_best(void);
+
+/**
+ Find the structural characters of JSON, like the first stage of simdjson:
+ operators outside strings, opening quotes, and the first byte of scalars.
+ The input is not validated beyond strings: a string should be closed and
+ should not contain control characters.
+ 
+ @param isa Instruction set, should be supported.
+ @param json JSON data.
+ @param size JSON data size in bytes, less than 4GB.
+ @param idx Output offsets in ascending order, should have at least `size` slots.
+ @return The offset count, or SIZE_MAX if the strings are invalid.
+ */
+usize json_scan_index(json_scan_isa isa, const char *json, usize size, u32 *idx);
+
+/**
+ Meansure `json_scan_index()` with the instruction set (see wrapper_reference.c).
+ 
+ @param isa Instruction set, should be supported.
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param count Structural count output.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if failed.
+ */
+u64 scan_measure_isa(json_scan_isa isa, const char *json, size_t size,
+                     usize *count, int repeat);
+
+/** Implementation of the standalone UTF-8 validator (see json_utf8.c). */
+typedef enum {
+    JSON_UTF8_SCALAR,   /* one code point at a time, 8-byte ASCII fast path */
+    JSON_UTF8_SIMD,     /* lookup algorithm, SSSE3 or NEON */
+    JSON_UTF8_IMPL_NUM
+} json_utf8_impl;
+
+/** Returns the name of the implementation, such as "ssse3". */
+const char *json_utf8_impl_name(json_utf8_impl impl);
+
+/** Whether the implementation is supported by the build and the running CPU. */
+bool json_utf8_supported(json_utf8_impl impl);
+
+/**
+ Validate UTF-8: no overlong encoding, surrogate, code point above U+10FFFF
+ or incomplete sequence.
+ 
+ @param impl Implementation, should be supported.
+ @param str The string, may contain null.
+ @param len The string length in bytes.
+ @return Whether the string is valid UTF-8.
+ */
+bool json_utf8_validate(json_utf8_impl impl, const char *str, usize len);
+
+/**
+ Meansure `json_utf8_validate()` with the implementation (see wrapper_reference.c).
+ 
+ @param impl Implementation, should be supported.
+ @param json JSON data in UTF-8 with null-terminator.
+ @param size JSON data size in bytes.
+ @param repeat Loop count for meansure.
+ @return The ticks cost of one loop, or 0 if failed.
+ */
+u64 utf8_measure_validator(json_utf8_impl impl, const char *json, size_t size, int repeat);
+
+/**
+ Generate a large JSON array by repeating the children of the largest
+ container in the input document, until the output reaches `target_size`.
+ 
+ @param json Input JSON data.
+ @param size Input JSON data size in bytes.
+ @param target_size Min output size in bytes.
+ @param out_size Output size in bytes.
+ @return Minified JSON with null-terminator, should be released with free().
+ */
+char *benchmark_gen_large_array(const char *json, usize size,
+                                usize target_size, usize *out_size);
+
+/**
+ Same as `benchmark_gen_large_array()`, but generates an object with
+ ascending number keys: {"0":...,"1":...}.
+ */
+char *benchmark_gen_large_object(const char *json, usize size,
+                                 usize target_size, usize *out_size);
+
+/**
+ Same as `benchmark_gen_large_array()`, but generates an array with exactly
+ `length` elements (length should not be 0).
+ */
+char *benchmark_gen_array_with_length(const char *json, usize size,
+                                      usize length, usize *out_size);
+
+/**
+ Generate a patch for the input document, the ops are spread over the scalars
+ of the document. JSON Patch cycles through replace, add, test, copy, move and
+ remove, JSON Merge Patch cycles through replace, delete and add (only the
+ members reachable through objects can be patched).
+ 
+ @param json Input JSON data.
+ @param size Input JSON data size in bytes.
+ @param op_count Max op count, the document may have less scalars.
+ @param merge Generate JSON Merge Patch (the root should be an object),
+    or JSON Patch.
+ @param out_ops Output op count.
+ @param out_size Output size in bytes.
+ @return Minified JSON with null-terminator, should be released with free(),
+    or NULL if no patch can be generated.
+ */
+char *benchmark_gen_patch(const char *json, usize size, usize op_count, bool merge,
+                          usize *out_ops, usize *out_size);
+
+/**
+ Collect objects (up to 1024, sampled in document order) and keys to lookup
+ for object lookup benchmark. At most 16 keys are picked from each object.
+ 
+ @param json Input JSON data.
+ @param size Input JSON data size in bytes.
+ @param hit Use the keys in objects, or the keys not in objects (same length
+    with a different last character, or a long key).
+ @param count Output target count.
+ @return Targets sorted by object width, should be released with
+    `benchmark_free_lookup_targets()`.
+ */
+lookup_target *benchmark_gen_lookup_targets(const char *json, usize size,
+                                            bool hit, usize *count);
+
+/** Release the targets from `benchmark_gen_lookup_targets()`. */
+void benchmark_free_lookup_targets(lookup_target *targets, usize count);
+
+/**
+ Parse a JSON Pointer (RFC 6901) into reference tokens (see json_pointer.c).
+ 
+ @param ptr Pointer string, empty string for the whole document.
+ @param len Pointer string length.
+ @param buf Buffer for the unescaped tokens, should be at least `len + 1` bytes.
+ @param tokens Output tokens.
+ @param max Max token count.
+ @return Token count, or SIZE_MAX if the pointer is invalid or too deep.
+ */
+usize json_pointer_parse(const char *ptr, usize len, char *buf,
+                         json_ptr_token *tokens, usize max);
+
+/** Returns whether the token is an array index (no leading zero or sign). */
+bool json_pointer_token_to_index(const json_ptr_token *token, usize *idx);
+
+/**
+ Generate JSON Pointers to the scalar values in a document (up to 1024,
+ sampled in document order), the deepest values are preferred.
+ 
+ @param json Input JSON data.
+ @param size Input JSON data size in bytes.
+ @param data Output pointers, should be released with `benchmark_free_pointers()`.
+ @return false on error.
+ */
+bool benchmark_gen_pointers(const char *json, usize size, pointer_data *data);
+
+/** Release the pointers from `benchmark_gen_pointers()`. */
+void benchmark_free_pointers(pointer_data *data);
+
+/**
+ Load the native data for DOM builder benchmark from twitter.json or
+ citm_catalog.json (detected by the root members).
+ 
+ @param json Input JSON data.
+ @param size Input JSON data size in bytes.
+ @param data Output data, should be released with `benchmark_free_build_data()`.
+ @return false if the document is not one of the supported files.
+ */
+bool benchmark_gen_build_data(const char *json, usize size, build_data *data);
+
+/** Release the data from `benchmark_gen_build_data()`. */
+void benchmark_free_build_data(build_data *data);
+
+/**
+ Collect all the string literals (keys and values) of a document as they are
+ in the source, with the original escapes, into a JSON array.
+ 
+ @param json Input JSON data, should be valid.
+ @param size Input JSON data size in bytes.
+ @param out_size Output size in bytes.
+ @return JSON array with null-terminator, should be released with free(),
+    or NULL if the document has no string.
+ */
+char *benchmark_gen_string_literals(const char *json, usize size, usize *out_size);
+
+/** Kind of the escapes in generated strings. */
+typedef enum {
+    STRING_GEN_ASCII,       /* \n \t \" \\ and other short escapes */
+    STRING_GEN_UNICODE,     /* \uXXXX of non-ASCII BMP characters */
+    STRING_GEN_SURROGATE    /* \uXXXX\uXXXX surrogate pairs */
+} string_gen_kind;
+
+/**
+ Generate a JSON array of strings with controlled escape density. Each string
+ has 64 characters, the characters not escaped are printable ASCII (include
+ '/'). The output is same for the same arguments.
+ 
+ @param kind Kind of the escapes.
+ @param density Ratio of the escaped characters, 0.0 to 1.0.
+ @param target_size Min output size in bytes.
+ @param out_size Output size in bytes.
+ @return JSON array with null-terminator, should be released with free().
+ */
+char *benchmark_gen_escaped_strings(string_gen_kind kind, f64 density,
+                                    usize target_size, usize *out_size);
+
+/** Kind of the generated blob documents. */
+typedef enum {
+    BLOB_GEN_BASE64,    /* attachments with base64 data, about 1MB each */
+    BLOB_GEN_LOG,       /* log records with long messages (1KB to 16KB) */
+    BLOB_GEN_HTML,      /* crawled pages with embedded HTML (16KB to 256KB) */
+    BLOB_GEN_KIND_NUM
+} blob_gen_kind;
+
+/** Returns the name of the blob kind, such as "base64". */
+const char *benchmark_blob_kind_name(blob_gen_kind kind);
+
+/**
+ Generate a document dominated by long string values. The output is same for
+ the same arguments.
+ 
+ @param kind Kind of the document.
+ @param target_size Min output size in bytes.
+ @param out_size Output size in bytes.
+ @return Minified JSON with null-terminator, should be released with free().
+ */
+char *benchmark_gen_blob(blob_gen_kind kind, usize target_size, usize *out_size);
+
+/**
+ Generate a document of double-encoded messages: the children of the largest
+ container in the input are serialized into the "payload" string of a message:
+ [{"topic":"<name>","seq":0,"payload":"{\"id\":1,...}"},...]
+ 
+ @param json Input JSON data.
+ @param size Input JSON data size in bytes.
+ @param topic The topic name of the messages.
+ @param out_count Output message count.
+ @param out_size Output size in bytes.
+ @return Minified JSON with null-terminator, should be released with free().
+ */
+char *benchmark_gen_nested(const char *json, usize size, const char *topic,
+                           usize *out_count, usize *out_size);
+
+/** Hash seed of jansson, pinned so the colliding keys can be generated. */
+#define JANSSON_HASH_SEED 0x5eed1234
+
+/** Kind of the generated adversarial documents. */
+typedef enum {
+    ADVERSARIAL_DEEP_ARRAY,     /* [[[...]]] nested 100000 levels */
+    ADVERSARIAL_DEEP_OBJECT,    /* {"a":{"a":...}} nested 100000 levels */
+    ADVERSARIAL_MANY_KEYS,      /* one object with 1000000 members */
+    ADVERSARIAL_HASH_COLLISION, /* 8192 keys in one bucket of jansson's hashtable */
+    ADVERSARIAL_LONG_NUMBER,    /* numbers with 10000 significant digits */
+    ADVERSARIAL_WHITESPACE,     /* 4096 whitespace characters around each token */
+    ADVERSARIAL_ESCAPE_RUN,     /* one string of escapes only */
+    ADVERSARIAL_KIND_NUM
+} adversarial_kind;
+
+/** Returns the name of the adversarial kind, such as "deep_array". */
+const char *benchmark_adversarial_kind_name(adversarial_kind kind);
+
+/**
+ Generate a worst-case document for parsers, all of them are valid JSON.
+ The output is same for the same kind.
+ 
+ @param kind Kind of the document.
+ @param out_size Output size in bytes.
+ @return JSON with null-terminator, should be released with free().
+ */
+char *benchmark_gen_adversarial(adversarial_kind kind, usize *out_size);
+
+/**
+ Compile a JSONPath string (see json_path.c for the supported syntax).
+ 
+ @param str JSONPath string, starts with `$`.
+ @param len JSONPath string length.
+ @return The compiled path, should be released with `json_path_free()`,
+    or NULL if the path is invalid or not supported.
+ */
+json_path *json_path_compile(const char *str, usize len);
+
+/** Release a compiled JSONPath. */
+void json_path_free(json_path *path);
+
+/**
+ Evaluate a compiled JSONPath on a DOM.
+ 
+ @param path The compiled JSONPath.
+ @param adapter The DOM access functions.
+ @param root The root value of the document.
+ @return Count of values matched.
+ */
+usize json_path_eval(const json_path *path, const json_path_adapter *adapter,
+                     json_path_val root);
+
+/** Test a filter step on a scalar value, `type` is JSON_PATH_NONE if missing. */
+bool json_path_filter_match(const json_path_step *step, json_path_type type,
+                            bool b, f64 num, const char *str, usize len);
+
+/**
+ Apply a JSON Patch (RFC 6902) in place with the shared implementation.
+ The ops stop at the first failure, the document is left partially patched.
+ 
+ @param adapter The DOM access functions.
+ @param root The root of the document to patch, the root itself cannot be
+    replaced or removed.
+ @param patch The root of the patch document (same library as `root`).
+ @return Whether all the ops are applied.
+ */
+bool json_patch_apply(const json_patch_adapter *adapter, void *root, void *patch);
+
+/**
+ Apply a JSON Merge Patch (RFC 7386) in place with the shared implementation.
+ Both the document root and the patch root should be objects.
+ */
+bool json_merge_patch_apply(const json_patch_adapter *adapter, void *root, void *patch);
+
+/** Result of a reader call in the sandbox (see benchmark_sandbox.c). */
+typedef enum {
+    SANDBOX_ACCEPT,     /* the reader parsed the JSON successfully */
+    SANDBOX_REJECT,     /* the reader reported a parse failure */
+    SANDBOX_CRASH,      /* killed by a signal or exited abnormally */
+    SANDBOX_TIMEOUT,    /* killed after the timeout */
+    SANDBOX_STATUS_NUM
+} sandbox_status;
+
+typedef struct {
+    sandbox_status status;
+    f64 seconds; /* wall time of the call, or the timeout */
+    usize mem; /* peak resident memory growth in bytes, 0 if unknown */
+} sandbox_result;
+
+/** Returns the name of the status, such as "crash". */
+const char *benchmark_sandbox_status_name(sandbox_status status);
+
+/** Whether the calls are isolated in a child process on this platform. */
+bool benchmark_sandbox_supported(void);
+
+/**
+ Call the reader once in a child process with a timeout and a memory limit,
+ so a crash or a hang of the library does not stop the benchmark. If the
+ sandbox is not supported, the reader is called in this process. An allocation
+ failure under the memory limit is a rejection or a crash, depending on how the
+ library handles it.
+ 
+ @param func The reader to call.
+ @param json JSON data with null-terminator.
+ @param size JSON data size in bytes.
+ @param timeout Timeout in seconds.
+ @param mem_limit Address space limit of the child in bytes, 0 for no limit.
+ @return The result of the call.
+ */
+sandbox_result benchmark_sandbox_read(reader_measure_func func, const char *json,
+                                      size_t size, f64 timeout, usize mem_limit);
+
+#ifdef __cplusplus
+}
+#endif
+
+
 
 /**
  The benchmark data directory path.
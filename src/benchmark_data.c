@@ -0,0 +1,1280 @@
+#include "benchmark.h"
+#include "yyjson.h"
+
+
+// -----------------------------------------------------------------------------
+// large array
+
+static void find_largest_container(yyjson_val *val, yyjson_val **max_ctn, usize *max_size) {
+    usize idx, max;
+    yyjson_val *k, *v;
+    if (yyjson_is_arr(val)) {
+        if (yyjson_arr_size(val) > *max_size) {
+            *max_size = yyjson_arr_size(val);
+            *max_ctn = val;
+        }
+        yyjson_arr_foreach(val, idx, max, v) {
+            if (yyjson_is_ctn(v)) find_largest_container(v, max_ctn, max_size);
+        }
+    } else if (yyjson_is_obj(val)) {
+        if (yyjson_obj_size(val) > *max_size) {
+            *max_size = yyjson_obj_size(val);
+            *max_ctn = val;
+        }
+        yyjson_obj_foreach(val, idx, max, k, v) {
+            if (yyjson_is_ctn(v)) find_largest_container(v, max_ctn, max_size);
+        }
+    }
+}
+
+static char *gen_large_container(const char *json, usize size, usize target_size,
+                                 usize target_count, usize *out_size, bool is_obj) {
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return NULL;
+    
+    // use the children of the largest container as elements, such as
+    // canada: coordinates, gsoc-2018: root object, twitter: statuses
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    yyjson_val *ctn = NULL;
+    usize ctn_size = 0;
+    find_largest_container(root, &ctn, &ctn_size);
+    
+    usize elem_num = ctn ? ctn_size : 1;
+    char **elems = calloc(elem_num, sizeof(char *));
+    usize idx, max;
+    yyjson_val *k, *v;
+    if (!ctn) {
+        elems[0] = yyjson_val_write(root, YYJSON_WRITE_NOFLAG, NULL);
+    } else if (yyjson_is_arr(ctn)) {
+        yyjson_arr_foreach(ctn, idx, max, v) {
+            elems[idx] = yyjson_val_write(v, YYJSON_WRITE_NOFLAG, NULL);
+        }
+    } else {
+        yyjson_obj_foreach(ctn, idx, max, k, v) {
+            elems[idx] = yyjson_val_write(v, YYJSON_WRITE_NOFLAG, NULL);
+        }
+    }
+    yyjson_doc_free(doc);
+    
+    // repeat the elements until reach the target size (or target count)
+    yy_sb sb;
+    yy_sb_init(&sb, target_size + size);
+    yy_sb_append(&sb, is_obj ? "{" : "[");
+    usize num = 0;
+    do {
+        for (usize e = 0; e < elem_num && (!target_count || num < target_count); e++, num++) {
+            if (num) yy_sb_append(&sb, ",");
+            if (is_obj) yy_sb_printf(&sb, "\"%llu\":", (unsigned long long)num);
+            yy_sb_append(&sb, elems[e] ? elems[e] : "null");
+        }
+    } while (target_count ? num < target_count : yy_sb_get_len(&sb) < target_size);
+    yy_sb_append(&sb, is_obj ? "}" : "]");
+    
+    for (usize e = 0; e < elem_num; e++) free(elems[e]);
+    free(elems);
+    
+    if (out_size) *out_size = yy_sb_get_len(&sb);
+    return yy_sb_get_str(&sb);
+}
+
+char *benchmark_gen_large_array(const char *json, usize size,
+                                usize target_size, usize *out_size) {
+    return gen_large_container(json, size, target_size, 0, out_size, false);
+}
+
+char *benchmark_gen_large_object(const char *json, usize size,
+                                 usize target_size, usize *out_size) {
+    return gen_large_container(json, size, target_size, 0, out_size, true);
+}
+
+char *benchmark_gen_array_with_length(const char *json, usize size,
+                                      usize length, usize *out_size) {
+    return gen_large_container(json, size, 0, length, out_size, false);
+}
+
+
+
+// -----------------------------------------------------------------------------
+// object lookup
+
+#define LOOKUP_MAX_TARGETS 1024
+#define LOOKUP_MAX_KEYS 16
+#define LOOKUP_MAX_DEPTH 64
+
+typedef struct {
+    yyjson_val *objs[LOOKUP_MAX_TARGETS];
+    const char **paths[LOOKUP_MAX_TARGETS]; /* copied path of each object */
+    usize depths[LOOKUP_MAX_TARGETS];
+    usize count;    /* objects collected */
+    usize seen;     /* objects visited */
+    usize stride;   /* collect one object every `stride` objects */
+    const char *path[LOOKUP_MAX_DEPTH];
+    char idx_buf[LOOKUP_MAX_DEPTH][24];
+} lookup_walker;
+
+static void lookup_walk(lookup_walker *w, yyjson_val *val, usize depth) {
+    usize idx, max;
+    yyjson_val *k, *v;
+    if (depth >= LOOKUP_MAX_DEPTH) return;
+    if (yyjson_is_obj(val)) {
+        if (yyjson_obj_size(val) > 0 && (w->seen++ % w->stride) == 0 &&
+            w->count < LOOKUP_MAX_TARGETS) {
+            const char **path = malloc((depth + 1) * sizeof(char *));
+            for (usize d = 0; d < depth; d++) path[d] = yy_str_copy(w->path[d]);
+            w->objs[w->count] = val;
+            w->paths[w->count] = path;
+            w->depths[w->count] = depth;
+            w->count++;
+        }
+        yyjson_obj_foreach(val, idx, max, k, v) {
+            if (!yyjson_is_ctn(v)) continue;
+            w->path[depth] = yyjson_get_str(k);
+            lookup_walk(w, v, depth + 1);
+        }
+    } else if (yyjson_is_arr(val)) {
+        yyjson_arr_foreach(val, idx, max, v) {
+            if (!yyjson_is_ctn(v)) continue;
+            snprintf(w->idx_buf[depth], sizeof(w->idx_buf[depth]), "%llu", (unsigned long long)idx);
+            w->path[depth] = w->idx_buf[depth];
+            lookup_walk(w, v, depth + 1);
+        }
+    }
+}
+
+static usize lookup_count_objs(yyjson_val *val) {
+    usize idx, max, num = yyjson_is_obj(val) && yyjson_obj_size(val) > 0;
+    yyjson_val *v;
+    if (yyjson_is_obj(val)) {
+        yyjson_val *k;
+        yyjson_obj_foreach(val, idx, max, k, v) num += lookup_count_objs(v);
+    } else if (yyjson_is_arr(val)) {
+        yyjson_arr_foreach(val, idx, max, v) num += lookup_count_objs(v);
+    }
+    return num;
+}
+
+/* Make a key which is not in the object: change the last character for even
+   index (same length, worst case for memcmp), or append a long suffix. */
+static char *lookup_make_miss(yyjson_val *obj, const char *key, usize len,
+                              usize i, usize *out_len) {
+    static const char *suffix = "_this_key_does_not_exist_in_the_object_0123456789";
+    usize slen = strlen(suffix);
+    char *str = malloc(len + slen + 1);
+    memcpy(str, key, len);
+    if ((i % 2 == 0) && len > 0) {
+        for (char c = 'A'; c <= 'z'; c++) {
+            str[len - 1] = c;
+            str[len] = '\0';
+            if (!yyjson_obj_getn(obj, str, len)) break;
+        }
+        *out_len = len;
+        if (!yyjson_obj_getn(obj, str, len)) return str;
+    }
+    memcpy(str + len, suffix, slen + 1);
+    *out_len = len + slen;
+    return str;
+}
+
+static int lookup_target_cmp(const void *a, const void *b) {
+    const lookup_target *ta = (const lookup_target *)a;
+    const lookup_target *tb = (const lookup_target *)b;
+    if (ta->width != tb->width) return ta->width < tb->width ? -1 : 1;
+    return 0;
+}
+
+lookup_target *benchmark_gen_lookup_targets(const char *json, usize size,
+                                            bool hit, usize *count) {
+    *count = 0;
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return NULL;
+    
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    lookup_walker *w = calloc(1, sizeof(lookup_walker));
+    usize total = lookup_count_objs(root);
+    w->stride = total / LOOKUP_MAX_TARGETS + 1;
+    lookup_walk(w, root, 0);
+    
+    lookup_target *targets = calloc(w->count ? w->count : 1, sizeof(lookup_target));
+    for (usize t = 0; t < w->count; t++) {
+        yyjson_val *obj = w->objs[t];
+        lookup_target *target = targets + t;
+        usize width = yyjson_obj_size(obj);
+        usize key_num = width < LOOKUP_MAX_KEYS ? width : LOOKUP_MAX_KEYS;
+        
+        target->depth = w->depths[t];
+        target->path = w->paths[t];
+        target->width = width;
+        target->key_count = key_num;
+        target->keys = malloc(key_num * sizeof(char *));
+        target->key_lens = malloc(key_num * sizeof(usize));
+        
+        // keys spread evenly in the object
+        for (usize i = 0; i < key_num; i++) {
+            yyjson_val *key = NULL;
+            usize pos = i * width / key_num, idx, max;
+            yyjson_val *k, *v;
+            yyjson_obj_foreach(obj, idx, max, k, v) {
+                if (idx == pos) {
+                    key = k;
+                    break;
+                }
+            }
+            const char *str = yyjson_get_str(key);
+            usize len = yyjson_get_len(key);
+            char *dst;
+            usize dst_len;
+            if (hit) {
+                dst = malloc(len + 1);
+                memcpy(dst, str, len);
+                dst[len] = '\0';
+                dst_len = len;
+            } else {
+                dst = lookup_make_miss(obj, str, len, i, &dst_len);
+            }
+            ((char **)target->keys)[i] = dst;
+            ((usize *)target->key_lens)[i] = dst_len;
+        }
+    }
+    
+    *count = w->count;
+    free(w);
+    yyjson_doc_free(doc);
+    qsort(targets, *count, sizeof(lookup_target), lookup_target_cmp);
+    return targets;
+}
+
+void benchmark_free_lookup_targets(lookup_target *targets, usize count) {
+    for (usize t = 0; t < count; t++) {
+        for (usize d = 0; d < targets[t].depth; d++) free((void *)targets[t].path[d]);
+        for (usize i = 0; i < targets[t].key_count; i++) free((void *)targets[t].keys[i]);
+        free((void *)targets[t].path);
+        free((void *)targets[t].keys);
+        free((void *)targets[t].key_lens);
+    }
+    free(targets);
+}
+
+
+
+// -----------------------------------------------------------------------------
+// pointer
+
+#define POINTER_MAX_COUNT 1024
+#define POINTER_MAX_DEPTH 64
+
+typedef struct {
+    usize depth_num[POINTER_MAX_DEPTH]; /* scalar count of each depth */
+    usize min_depth;    /* collect the scalars not less than this depth */
+    usize seen;         /* scalars visited (not less than min_depth) */
+    usize stride;       /* collect one scalar every `stride` scalars */
+    yy_sb *sbs;         /* pointer strings */
+    usize count;        /* pointers collected */
+    yyjson_val *keys[POINTER_MAX_DEPTH]; /* key, or NULL for array index */
+    usize idxs[POINTER_MAX_DEPTH];
+} pointer_walker;
+
+static void pointer_walk(pointer_walker *w, yyjson_val *val, usize depth, bool collect) {
+    usize idx, max;
+    yyjson_val *k, *v;
+    if (depth >= POINTER_MAX_DEPTH) return;
+    if (yyjson_is_obj(val)) {
+        yyjson_obj_foreach(val, idx, max, k, v) {
+            w->keys[depth] = k;
+            pointer_walk(w, v, depth + 1, collect);
+        }
+    } else if (yyjson_is_arr(val)) {
+        yyjson_arr_foreach(val, idx, max, v) {
+            w->keys[depth] = NULL;
+            w->idxs[depth] = idx;
+            pointer_walk(w, v, depth + 1, collect);
+        }
+    } else if (!collect) {
+        w->depth_num[depth]++;
+    } else if (depth >= w->min_depth && (w->seen++ % w->stride) == 0 &&
+               w->count < POINTER_MAX_COUNT) {
+        yy_sb *sb = w->sbs + w->count++;
+        yy_sb_init(sb, 64);
+        for (usize d = 0; d < depth; d++) {
+            yyjson_val *key = w->keys[d];
+            if (!key) {
+                yy_sb_printf(sb, "/%llu", (unsigned long long)w->idxs[d]);
+                continue;
+            }
+            const char *str = yyjson_get_str(key);
+            usize len = yyjson_get_len(key);
+            yy_sb_append(sb, "/");
+            for (usize i = 0; i < len; i++) {
+                if (str[i] == '~') yy_sb_append(sb, "~0");
+                else if (str[i] == '/') yy_sb_append(sb, "~1");
+                else yy_buf_append(sb, (u8 *)str + i, 1);
+            }
+        }
+    }
+}
+
+bool benchmark_gen_pointers(const char *json, usize size, pointer_data *data) {
+    memset(data, 0, sizeof(pointer_data));
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return false;
+    
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    pointer_walker *w = calloc(1, sizeof(pointer_walker));
+    pointer_walk(w, root, 0, false);
+    
+    // prefer the deepest scalars, but at least POINTER_MAX_COUNT if possible
+    usize total = 0;
+    for (usize d = POINTER_MAX_DEPTH; d > 0; d--) {
+        total += w->depth_num[d - 1];
+        w->min_depth = d - 1;
+        if (total >= POINTER_MAX_COUNT) break;
+    }
+    w->stride = total / POINTER_MAX_COUNT + 1;
+    w->sbs = calloc(POINTER_MAX_COUNT, sizeof(yy_sb));
+    pointer_walk(w, root, 0, true);
+    yyjson_doc_free(doc);
+    
+    usize count = w->count;
+    const char **ptrs = malloc((count + 1) * sizeof(char *));
+    usize *lens = malloc((count + 1) * sizeof(usize));
+    const json_ptr_token **tokens = malloc((count + 1) * sizeof(json_ptr_token *));
+    usize *token_counts = malloc((count + 1) * sizeof(usize));
+    for (usize i = 0; i < count; i++) {
+        usize len = yy_sb_get_len(w->sbs + i);
+        char *ptr = yy_sb_get_str(w->sbs + i);
+        
+        // tokens and the unescaped strings in one allocation
+        json_ptr_token *toks = malloc(POINTER_MAX_DEPTH * sizeof(json_ptr_token) + len + 1);
+        char *buf = (char *)(toks + POINTER_MAX_DEPTH);
+        ptrs[i] = ptr;
+        lens[i] = len;
+        tokens[i] = toks;
+        token_counts[i] = json_pointer_parse(ptr, len, buf, toks, POINTER_MAX_DEPTH);
+    }
+    free(w->sbs);
+    free(w);
+    
+    data->count = count;
+    data->ptrs = ptrs;
+    data->lens = lens;
+    data->tokens = tokens;
+    data->token_counts = token_counts;
+    return count > 0;
+}
+
+void benchmark_free_pointers(pointer_data *data) {
+    for (usize i = 0; i < data->count; i++) {
+        free((void *)data->ptrs[i]);
+        free((void *)data->tokens[i]);
+    }
+    free((void *)data->ptrs);
+    free((void *)data->lens);
+    free((void *)data->tokens);
+    free((void *)data->token_counts);
+    memset(data, 0, sizeof(pointer_data));
+}
+
+
+
+// -----------------------------------------------------------------------------
+// patch
+
+#define PATCH_MAX_DEPTH 64
+
+typedef struct {
+    yy_sb ptr;          /* pointer of the scalar */
+    usize obj_len;      /* pointer length of the nearest object ancestor, or SIZE_MAX */
+    bool obj_only;      /* all the ancestors are objects */
+    yyjson_val *val;
+} patch_leaf;
+
+typedef struct {
+    usize seen;         /* scalars visited */
+    usize stride;       /* collect one scalar every `stride` scalars */
+    usize max;          /* max scalars to collect */
+    patch_leaf *leaves;
+    usize count;
+    yyjson_val *keys[PATCH_MAX_DEPTH]; /* key, or NULL for array index */
+    usize idxs[PATCH_MAX_DEPTH];
+} patch_walker;
+
+static void patch_walk(patch_walker *w, yyjson_val *val, usize depth) {
+    usize idx, max;
+    yyjson_val *k, *v;
+    if (depth >= PATCH_MAX_DEPTH) return;
+    if (yyjson_is_obj(val)) {
+        yyjson_obj_foreach(val, idx, max, k, v) {
+            w->keys[depth] = k;
+            patch_walk(w, v, depth + 1);
+        }
+    } else if (yyjson_is_arr(val)) {
+        yyjson_arr_foreach(val, idx, max, v) {
+            w->keys[depth] = NULL;
+            w->idxs[depth] = idx;
+            patch_walk(w, v, depth + 1);
+        }
+    } else if ((w->seen++ % w->stride) == 0 && w->leaves && w->count < w->max) {
+        patch_leaf *leaf = w->leaves + w->count++;
+        yy_sb *sb = &leaf->ptr;
+        yy_sb_init(sb, 64);
+        leaf->obj_len = SIZE_MAX;
+        leaf->obj_only = true;
+        leaf->val = val;
+        for (usize d = 0; d < depth; d++) {
+            yyjson_val *key = w->keys[d];
+            if (key) leaf->obj_len = yy_sb_get_len(sb);
+            else leaf->obj_only = false;
+            if (!key) {
+                yy_sb_printf(sb, "/%llu", (unsigned long long)w->idxs[d]);
+                continue;
+            }
+            const char *str = yyjson_get_str(key);
+            usize len = yyjson_get_len(key);
+            yy_sb_append(sb, "/");
+            for (usize i = 0; i < len; i++) {
+                if (str[i] == '~') yy_sb_append(sb, "~0");
+                else if (str[i] == '/') yy_sb_append(sb, "~1");
+                else yy_buf_append(sb, (u8 *)str + i, 1);
+            }
+        }
+    }
+}
+
+/* Returns a pointer string: prefix of the leaf's pointer + "/<name><k>". */
+static yyjson_mut_val *patch_make_path(yyjson_mut_doc *doc, patch_leaf *leaf,
+                                       const char *name, usize k) {
+    char buf[32];
+    yy_sb sb;
+    yy_sb_init(&sb, leaf->obj_len + 32);
+    yy_buf_append(&sb, (u8 *)yy_sb_get_str(&leaf->ptr), leaf->obj_len);
+    snprintf(buf, sizeof(buf), "/%s%llu", name, (unsigned long long)k);
+    yy_sb_append(&sb, buf);
+    yyjson_mut_val *val = yyjson_mut_strncpy(doc, yy_sb_get_str(&sb), yy_sb_get_len(&sb));
+    yy_sb_release(&sb);
+    return val;
+}
+
+static yyjson_mut_val *patch_make_op(yyjson_mut_doc *doc, yyjson_mut_val *arr, const char *op,
+                                     yyjson_mut_val *path, yyjson_mut_val *from) {
+    yyjson_mut_val *obj = yyjson_mut_arr_add_obj(doc, arr);
+    yyjson_mut_obj_add_str(doc, obj, "op", op);
+    if (from) yyjson_mut_obj_add_val(doc, obj, "from", from);
+    yyjson_mut_obj_add_val(doc, obj, "path", path);
+    return obj;
+}
+
+static void patch_gen_json_patch(yyjson_mut_doc *doc, patch_leaf *leaves, usize count) {
+    yyjson_mut_val *arr = yyjson_mut_arr(doc);
+    yyjson_mut_val *added = NULL, *moved = NULL, *obj, *path;
+    patch_leaf *added_leaf = NULL;
+    yyjson_mut_doc_set_root(doc, arr);
+    
+    // add, move and remove are applied to new members only, so all the paths
+    // stay valid; each scalar is used once, so test always passes
+    for (usize k = 0; k < count; k++) {
+        patch_leaf *leaf = leaves + k;
+        yyjson_mut_val *leaf_path = yyjson_mut_strncpy(doc, yy_sb_get_str(&leaf->ptr),
+                                                       yy_sb_get_len(&leaf->ptr));
+        bool has_obj = leaf->obj_len != SIZE_MAX;
+        
+        // replace, add, test, copy, move, remove
+        int kind = (int)(k % 6);
+        if (kind == 1 && !has_obj) kind = 0;
+        if (kind == 3 && !has_obj) kind = 2;
+        if (kind == 4 && !added) kind = 0;
+        if (kind == 5 && !moved) kind = 2;
+        switch (kind) {
+            case 0:
+                obj = patch_make_op(doc, arr, "replace", leaf_path, NULL);
+                yyjson_mut_obj_add_uint(doc, obj, "value", k);
+                break;
+            case 1:
+                added = patch_make_path(doc, leaf, "_patch", k);
+                added_leaf = leaf;
+                obj = patch_make_op(doc, arr, "add", added, NULL);
+                obj = yyjson_mut_obj_add_obj(doc, obj, "value");
+                yyjson_mut_obj_add_uint(doc, obj, "k", k);
+                break;
+            case 2:
+                obj = patch_make_op(doc, arr, "test", leaf_path, NULL);
+                yyjson_mut_obj_add_val(doc, obj, "value", yyjson_val_mut_copy(doc, leaf->val));
+                break;
+            case 3:
+                path = patch_make_path(doc, leaf, "_copy", k);
+                patch_make_op(doc, arr, "copy", path, leaf_path);
+                break;
+            case 4:
+                moved = patch_make_path(doc, added_leaf, "_move", k);
+                patch_make_op(doc, arr, "move", moved, yyjson_mut_val_mut_copy(doc, added));
+                added = NULL;
+                break;
+            default:
+                patch_make_op(doc, arr, "remove", yyjson_mut_val_mut_copy(doc, moved), NULL);
+                moved = NULL;
+                break;
+        }
+    }
+}
+
+static usize patch_gen_merge_patch(yyjson_mut_doc *doc, patch_leaf *leaves, usize count) {
+    yyjson_mut_val *root = yyjson_mut_obj(doc);
+    json_ptr_token tokens[PATCH_MAX_DEPTH];
+    usize num = 0;
+    yyjson_mut_doc_set_root(doc, root);
+    
+    for (usize k = 0; k < count; k++) {
+        patch_leaf *leaf = leaves + k;
+        if (!leaf->obj_only) continue;
+        usize len = yy_sb_get_len(&leaf->ptr);
+        char *buf = malloc(len + 1);
+        usize token_count = json_pointer_parse(yy_sb_get_str(&leaf->ptr), len, buf,
+                                               tokens, PATCH_MAX_DEPTH);
+        if (token_count == SIZE_MAX || token_count == 0) {
+            free(buf);
+            continue;
+        }
+        
+        // create the parent objects in patch
+        yyjson_mut_val *cur = root;
+        for (usize t = 0; t + 1 < token_count; t++) {
+            yyjson_mut_val *sub = yyjson_mut_obj_getn(cur, tokens[t].str, tokens[t].len);
+            if (!sub) {
+                sub = yyjson_mut_obj(doc);
+                yyjson_mut_obj_add(cur, yyjson_mut_strncpy(doc, tokens[t].str, tokens[t].len), sub);
+            }
+            cur = sub;
+        }
+        
+        // replace, delete, or add a new member
+        json_ptr_token *last = tokens + token_count - 1;
+        yyjson_mut_val *key = yyjson_mut_strncpy(doc, last->str, last->len);
+        if (num % 3 == 0) {
+            yyjson_mut_obj_add(cur, key, yyjson_mut_uint(doc, k));
+        } else if (num % 3 == 1) {
+            yyjson_mut_obj_add(cur, key, yyjson_mut_null(doc));
+        } else {
+            char name[32];
+            snprintf(name, sizeof(name), "_patch%llu", (unsigned long long)k);
+            yyjson_mut_val *val = yyjson_mut_obj(doc);
+            yyjson_mut_obj_add_uint(doc, val, "k", k);
+            yyjson_mut_obj_add(cur, yyjson_mut_strcpy(doc, name), val);
+        }
+        num++;
+        free(buf);
+    }
+    return num;
+}
+
+char *benchmark_gen_patch(const char *json, usize size, usize op_count, bool merge,
+                          usize *out_ops, usize *out_size) {
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return NULL;
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    if (merge && !yyjson_is_obj(root)) {
+        yyjson_doc_free(doc);
+        return NULL;
+    }
+    
+    // spread the scalars over the document
+    patch_walker *w = calloc(1, sizeof(patch_walker));
+    w->stride = 1;
+    patch_walk(w, root, 0);
+    w->stride = w->seen / (op_count ? op_count : 1) + 1;
+    w->seen = 0;
+    w->max = op_count;
+    w->leaves = calloc(op_count + 1, sizeof(patch_leaf));
+    patch_walk(w, root, 0);
+    
+    yyjson_mut_doc *mdoc = yyjson_mut_doc_new(NULL);
+    usize ops = w->count;
+    if (merge) ops = patch_gen_merge_patch(mdoc, w->leaves, w->count);
+    else patch_gen_json_patch(mdoc, w->leaves, w->count);
+    char *str = ops ? yyjson_mut_write(mdoc, YYJSON_WRITE_NOFLAG, out_size) : NULL;
+    
+    for (usize i = 0; i < w->count; i++) yy_sb_release(&w->leaves[i].ptr);
+    free(w->leaves);
+    free(w);
+    yyjson_mut_doc_free(mdoc);
+    yyjson_doc_free(doc);
+    if (out_ops) *out_ops = str ? ops : 0;
+    return str;
+}
+
+
+
+// -----------------------------------------------------------------------------
+// build
+
+typedef struct {
+    yyjson_doc *doc;    /* the strings point into the document */
+    usize count;
+    usize cap;
+    void **allocs;
+} build_owner;
+
+static void *build_alloc(build_owner *owner, usize count, usize size) {
+    if (owner->count == owner->cap) {
+        owner->cap = owner->cap ? owner->cap * 2 : 64;
+        owner->allocs = realloc(owner->allocs, owner->cap * sizeof(void *));
+    }
+    void *mem = calloc(count + 1, size);
+    owner->allocs[owner->count++] = mem;
+    return mem;
+}
+
+static build_str build_get_str(yyjson_val *obj, const char *key) {
+    build_str str = { NULL, 0 };
+    yyjson_val *val = yyjson_obj_get(obj, key);
+    if (yyjson_is_str(val)) {
+        str.str = yyjson_get_str(val);
+        str.len = yyjson_get_len(val);
+    }
+    return str;
+}
+
+static u64 build_get_uint(yyjson_val *obj, const char *key) {
+    return yyjson_get_uint(yyjson_obj_get(obj, key));
+}
+
+static const u64 *build_get_uints(build_owner *owner, yyjson_val *arr, usize *count) {
+    usize idx, max;
+    yyjson_val *val;
+    u64 *ids = build_alloc(owner, yyjson_arr_size(arr), sizeof(u64));
+    yyjson_arr_foreach(arr, idx, max, val) ids[idx] = yyjson_get_uint(val);
+    *count = yyjson_arr_size(arr);
+    return ids;
+}
+
+static void build_get_indices(yyjson_val *obj, u64 indices[2]) {
+    yyjson_val *arr = yyjson_obj_get(obj, "indices");
+    indices[0] = yyjson_get_uint(yyjson_arr_get(arr, 0));
+    indices[1] = yyjson_get_uint(yyjson_arr_get(arr, 1));
+}
+
+static void build_load_user(build_user *user, yyjson_val *obj) {
+    user->id = build_get_uint(obj, "id");
+    user->id_str = build_get_str(obj, "id_str");
+    user->name = build_get_str(obj, "name");
+    user->screen_name = build_get_str(obj, "screen_name");
+    user->location = build_get_str(obj, "location");
+    user->description = build_get_str(obj, "description");
+    user->is_protected = yyjson_get_bool(yyjson_obj_get(obj, "protected"));
+    user->followers_count = build_get_uint(obj, "followers_count");
+    user->friends_count = build_get_uint(obj, "friends_count");
+    user->listed_count = build_get_uint(obj, "listed_count");
+    user->created_at = build_get_str(obj, "created_at");
+    user->favourites_count = build_get_uint(obj, "favourites_count");
+    user->verified = yyjson_get_bool(yyjson_obj_get(obj, "verified"));
+    user->statuses_count = build_get_uint(obj, "statuses_count");
+    user->lang = build_get_str(obj, "lang");
+    user->profile_image_url = build_get_str(obj, "profile_image_url");
+}
+
+static build_twitter *build_load_twitter(build_owner *owner, yyjson_val *root) {
+    usize idx, max, i, n;
+    yyjson_val *st, *val;
+    yyjson_val *statuses = yyjson_obj_get(root, "statuses");
+    yyjson_val *meta = yyjson_obj_get(root, "search_metadata");
+    build_twitter *tw = build_alloc(owner, 1, sizeof(build_twitter));
+    build_status *sts = build_alloc(owner, yyjson_arr_size(statuses), sizeof(build_status));
+    
+    yyjson_arr_foreach(statuses, idx, max, st) {
+        build_status *s = sts + idx;
+        yyjson_val *ent = yyjson_obj_get(st, "entities");
+        s->created_at = build_get_str(st, "created_at");
+        s->id = build_get_uint(st, "id");
+        s->id_str = build_get_str(st, "id_str");
+        s->text = build_get_str(st, "text");
+        s->source = build_get_str(st, "source");
+        s->truncated = yyjson_get_bool(yyjson_obj_get(st, "truncated"));
+        s->in_reply_to_status_id = build_get_uint(st, "in_reply_to_status_id");
+        s->in_reply_to_status_id_str = build_get_str(st, "in_reply_to_status_id_str");
+        s->in_reply_to_user_id = build_get_uint(st, "in_reply_to_user_id");
+        s->in_reply_to_user_id_str = build_get_str(st, "in_reply_to_user_id_str");
+        s->in_reply_to_screen_name = build_get_str(st, "in_reply_to_screen_name");
+        build_load_user(&s->user, yyjson_obj_get(st, "user"));
+        s->retweet_count = build_get_uint(st, "retweet_count");
+        s->favorite_count = build_get_uint(st, "favorite_count");
+        s->favorited = yyjson_get_bool(yyjson_obj_get(st, "favorited"));
+        s->retweeted = yyjson_get_bool(yyjson_obj_get(st, "retweeted"));
+        s->lang = build_get_str(st, "lang");
+        
+        yyjson_val *tags = yyjson_obj_get(ent, "hashtags");
+        build_hashtag *hashtags = build_alloc(owner, yyjson_arr_size(tags), sizeof(build_hashtag));
+        yyjson_arr_foreach(tags, i, n, val) {
+            hashtags[i].text = build_get_str(val, "text");
+            build_get_indices(val, hashtags[i].indices);
+        }
+        s->hashtag_count = yyjson_arr_size(tags);
+        s->hashtags = hashtags;
+        
+        yyjson_val *mens = yyjson_obj_get(ent, "user_mentions");
+        build_mention *mentions = build_alloc(owner, yyjson_arr_size(mens), sizeof(build_mention));
+        yyjson_arr_foreach(mens, i, n, val) {
+            mentions[i].screen_name = build_get_str(val, "screen_name");
+            mentions[i].name = build_get_str(val, "name");
+            mentions[i].id = build_get_uint(val, "id");
+            mentions[i].id_str = build_get_str(val, "id_str");
+            build_get_indices(val, mentions[i].indices);
+        }
+        s->mention_count = yyjson_arr_size(mens);
+        s->mentions = mentions;
+    }
+    tw->status_count = yyjson_arr_size(statuses);
+    tw->statuses = sts;
+    
+    tw->completed_in = yyjson_get_real(yyjson_obj_get(meta, "completed_in"));
+    tw->max_id = build_get_uint(meta, "max_id");
+    tw->max_id_str = build_get_str(meta, "max_id_str");
+    tw->next_results = build_get_str(meta, "next_results");
+    tw->query = build_get_str(meta, "query");
+    tw->refresh_url = build_get_str(meta, "refresh_url");
+    tw->count = build_get_uint(meta, "count");
+    tw->since_id = build_get_uint(meta, "since_id");
+    tw->since_id_str = build_get_str(meta, "since_id_str");
+    return tw;
+}
+
+static build_citm *build_load_citm(build_owner *owner, yyjson_val *root) {
+    static const char *map_names[] = {
+        "areaNames", "audienceSubCategoryNames", "blockNames", "seatCategoryNames",
+        "subTopicNames", "subjectNames", "topicNames", "venueNames"
+    };
+    usize map_num = sizeof(map_names) / sizeof(map_names[0]);
+    usize idx, max, i, n;
+    yyjson_val *key, *val, *sub;
+    build_citm *citm = build_alloc(owner, 1, sizeof(build_citm));
+    
+    yyjson_val *evts = yyjson_obj_get(root, "events");
+    build_event *events = build_alloc(owner, yyjson_obj_size(evts), sizeof(build_event));
+    yyjson_obj_foreach(evts, idx, max, key, val) {
+        build_event *e = events + idx;
+        e->key.str = yyjson_get_str(key);
+        e->key.len = yyjson_get_len(key);
+        e->id = build_get_uint(val, "id");
+        e->logo = build_get_str(val, "logo");
+        e->name = build_get_str(val, "name");
+        e->sub_topic_ids = build_get_uints(owner, yyjson_obj_get(val, "subTopicIds"),
+                                           &e->sub_topic_count);
+        e->topic_ids = build_get_uints(owner, yyjson_obj_get(val, "topicIds"), &e->topic_count);
+    }
+    citm->event_count = yyjson_obj_size(evts);
+    citm->events = events;
+    
+    yyjson_val *perfs = yyjson_obj_get(root, "performances");
+    build_performance *performances = build_alloc(owner, yyjson_arr_size(perfs),
+                                                  sizeof(build_performance));
+    yyjson_arr_foreach(perfs, idx, max, val) {
+        build_performance *p = performances + idx;
+        p->event_id = build_get_uint(val, "eventId");
+        p->id = build_get_uint(val, "id");
+        p->logo = build_get_str(val, "logo");
+        p->start = build_get_uint(val, "start");
+        p->venue_code = build_get_str(val, "venueCode");
+        
+        yyjson_val *arr = yyjson_obj_get(val, "prices");
+        build_price *prices = build_alloc(owner, yyjson_arr_size(arr), sizeof(build_price));
+        yyjson_arr_foreach(arr, i, n, sub) {
+            prices[i].amount = build_get_uint(sub, "amount");
+            prices[i].audience_sub_category_id = build_get_uint(sub, "audienceSubCategoryId");
+            prices[i].seat_category_id = build_get_uint(sub, "seatCategoryId");
+        }
+        p->price_count = yyjson_arr_size(arr);
+        p->prices = prices;
+        
+        arr = yyjson_obj_get(val, "seatCategories");
+        build_seat_category *cats = build_alloc(owner, yyjson_arr_size(arr),
+                                                sizeof(build_seat_category));
+        yyjson_arr_foreach(arr, i, n, sub) {
+            yyjson_val *areas = yyjson_obj_get(sub, "areas"), *area;
+            usize a, a_max;
+            u64 *ids = build_alloc(owner, yyjson_arr_size(areas), sizeof(u64));
+            yyjson_arr_foreach(areas, a, a_max, area) ids[a] = build_get_uint(area, "areaId");
+            cats[i].area_count = yyjson_arr_size(areas);
+            cats[i].area_ids = ids;
+            cats[i].seat_category_id = build_get_uint(sub, "seatCategoryId");
+        }
+        p->seat_category_count = yyjson_arr_size(arr);
+        p->seat_categories = cats;
+    }
+    citm->performance_count = yyjson_arr_size(perfs);
+    citm->performances = performances;
+    
+    build_name_map *maps = build_alloc(owner, map_num, sizeof(build_name_map));
+    for (usize m = 0; m < map_num; m++) {
+        yyjson_val *obj = yyjson_obj_get(root, map_names[m]);
+        build_name *names = build_alloc(owner, yyjson_obj_size(obj), sizeof(build_name));
+        yyjson_obj_foreach(obj, idx, max, key, val) {
+            names[idx].key.str = yyjson_get_str(key);
+            names[idx].key.len = yyjson_get_len(key);
+            names[idx].name.str = yyjson_get_str(val);
+            names[idx].name.len = yyjson_get_len(val);
+        }
+        maps[m].name.str = map_names[m];
+        maps[m].name.len = strlen(map_names[m]);
+        maps[m].count = yyjson_obj_size(obj);
+        maps[m].names = names;
+    }
+    citm->map_count = map_num;
+    citm->maps = maps;
+    return citm;
+}
+
+bool benchmark_gen_build_data(const char *json, usize size, build_data *data) {
+    memset(data, 0, sizeof(build_data));
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    bool is_twitter = yyjson_is_arr(yyjson_obj_get(root, "statuses"));
+    bool is_citm = yyjson_is_arr(yyjson_obj_get(root, "performances"));
+    if (!is_twitter && !is_citm) {
+        yyjson_doc_free(doc);
+        return false;
+    }
+    
+    build_owner *owner = calloc(1, sizeof(build_owner));
+    owner->doc = doc;
+    if (is_twitter) data->twitter = build_load_twitter(owner, root);
+    else data->citm = build_load_citm(owner, root);
+    data->owner = owner;
+    return true;
+}
+
+void benchmark_free_build_data(build_data *data) {
+    build_owner *owner = (build_owner *)data->owner;
+    if (owner) {
+        for (usize i = 0; i < owner->count; i++) free(owner->allocs[i]);
+        free(owner->allocs);
+        yyjson_doc_free(owner->doc);
+        free(owner);
+    }
+    memset(data, 0, sizeof(build_data));
+}
+
+
+// -----------------------------------------------------------------------------
+// string
+
+char *benchmark_gen_string_literals(const char *json, usize size, usize *out_size) {
+    // the output is never longer than the input plus the brackets
+    char *buf = malloc(size + 3);
+    if (!buf) return NULL;
+    usize len = 0;
+    buf[len++] = '[';
+    
+    // quotes only appear in strings, the source is copied as is
+    const char *cur = json, *end = json + size;
+    while (cur < end) {
+        if (*cur != '"') {
+            cur++;
+            continue;
+        }
+        const char *hdr = cur++;
+        while (cur < end && *cur != '"') cur += (*cur == '\\') ? 2 : 1;
+        if (cur >= end) break;
+        cur++;
+        if (len > 1) buf[len++] = ',';
+        memcpy(buf + len, hdr, (usize)(cur - hdr));
+        len += (usize)(cur - hdr);
+    }
+    if (len == 1) {
+        free(buf);
+        return NULL;
+    }
+    buf[len++] = ']';
+    buf[len] = '\0';
+    *out_size = len;
+    return buf;
+}
+
+#define STRING_GEN_CHARS 64
+#define STRING_GEN_MAX_LEN (STRING_GEN_CHARS * 12 + 3) /* surrogate pairs */
+
+char *benchmark_gen_escaped_strings(string_gen_kind kind, f64 density,
+                                    usize target_size, usize *out_size) {
+    static const char plain[] = "abcdefghijklmnopqrstuvwxyz"
+                                "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 /.:-_";
+    static const char *shorts[] = { "\\n", "\\t", "\\r", "\\b", "\\f", "\\\"", "\\\\" };
+    u32 threshold = (u32)(density * (f64)UINT32_MAX);
+    
+    char *buf = malloc(target_size + STRING_GEN_MAX_LEN + 2);
+    if (!buf) return NULL;
+    usize len = 0;
+    buf[len++] = '[';
+    yy_random_reset();
+    while (len < target_size) {
+        if (len > 1) buf[len++] = ',';
+        buf[len++] = '"';
+        for (int i = 0; i < STRING_GEN_CHARS; i++) {
+            bool escape = density >= 1.0 || (density > 0.0 && yy_random32() < threshold);
+            if (!escape) {
+                buf[len++] = plain[yy_random32_uniform(sizeof(plain) - 1)];
+            } else if (kind == STRING_GEN_ASCII) {
+                const char *esc = shorts[yy_random32_uniform(sizeof(shorts) / sizeof(shorts[0]))];
+                buf[len++] = esc[0];
+                buf[len++] = esc[1];
+            } else if (kind == STRING_GEN_UNICODE) {
+                // U+0080 to U+FFFD, skip the surrogates
+                u32 cp = yy_random32_range(0x80, 0xFFFD - 0x800);
+                if (cp >= 0xD800) cp += 0x800;
+                len += (usize)snprintf(buf + len, 7, "\\u%04X", cp);
+            } else {
+                u32 cp = yy_random32_uniform(0x100000);
+                len += (usize)snprintf(buf + len, 13, "\\u%04X\\u%04X",
+                                       0xD800 + (cp >> 10), 0xDC00 + (cp & 0x3FF));
+            }
+        }
+        buf[len++] = '"';
+    }
+    buf[len++] = ']';
+    buf[len] = '\0';
+    *out_size = len;
+    return buf;
+}
+
+
+// -----------------------------------------------------------------------------
+// blob
+
+static const char *blob_words[] = {
+    "request", "session", "user", "cache", "timeout", "retry", "upstream",
+    "payload", "connection", "handler", "latency", "queue", "worker", "token",
+    "status", "invalid", "the", "from", "with", "for", "and", "was", "after"
+};
+#define BLOB_WORD_NUM (sizeof(blob_words) / sizeof(blob_words[0]))
+
+static void blob_gen_base64(yy_sb *sb, usize n) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    usize bytes = 768 * 1024 + yy_random32_uniform(256 * 1024);
+    bytes -= bytes % 3;
+    yy_sb_printf(sb, "{\"id\":%zu,\"name\":\"attachment-%zu.bin\","
+                 "\"type\":\"application/octet-stream\",\"size\":%zu,\"sha1\":\"", n, n, bytes);
+    for (int i = 0; i < 5; i++) yy_sb_printf(sb, "%08x", yy_random32());
+    yy_sb_append(sb, "\",\"data\":\"");
+    // random bytes encode to all 64 characters, include '/'
+    yy_buf_grow(sb, bytes / 3 * 4);
+    for (usize i = 0; i < bytes; i += 3) {
+        u32 v = yy_random32() & 0xFFFFFF;
+        *sb->cur++ = (u8)table[(v >> 18) & 0x3F];
+        *sb->cur++ = (u8)table[(v >> 12) & 0x3F];
+        *sb->cur++ = (u8)table[(v >> 6) & 0x3F];
+        *sb->cur++ = (u8)table[v & 0x3F];
+    }
+    yy_sb_append(sb, "\"}");
+}
+
+static void blob_gen_log(yy_sb *sb, usize n) {
+    usize len = 1024 + yy_random32_uniform(15 * 1024);
+    yy_sb_printf(sb, "{\"ts\":\"2024-05-01T%02u:%02u:%02u.%03uZ\",\"level\":\"%s\",\"host\":\"web-%u\",\"msg\":\"",
+                 (u32)(n / 3600 % 24), (u32)(n / 60 % 60), (u32)(n % 60), yy_random32_uniform(1000),
+                 yy_random32_uniform(8) ? "INFO" : "ERROR", yy_random32_uniform(16));
+    // a long line with key=value pairs, quoted values and tab separated fields
+    usize end = yy_sb_get_len(sb) + len;
+    while (yy_sb_get_len(sb) < end) {
+        u32 r = yy_random32_uniform(16);
+        const char *word = blob_words[yy_random32_uniform(BLOB_WORD_NUM)];
+        if (r == 0) yy_sb_printf(sb, "%s=\\\"%s\\\" ", word, blob_words[yy_random32_uniform(BLOB_WORD_NUM)]);
+        else if (r == 1) yy_sb_printf(sb, "%s=%u\\t", word, yy_random32_uniform(100000));
+        else yy_sb_printf(sb, "%s ", word);
+    }
+    yy_sb_append(sb, "\"}");
+}
+
+static void blob_gen_html(yy_sb *sb, usize n) {
+    usize len = 16 * 1024 + yy_random32_uniform(240 * 1024);
+    yy_sb_printf(sb, "{\"url\":\"https://example.com/page/%zu\",\"status\":200,\"html\":\"", n);
+    yy_sb_printf(sb, "<!DOCTYPE html>\\n<html lang=\\\"en\\\">\\n<head>\\n<meta charset=\\\"utf-8\\\">\\n"
+                 "<title>Page %zu</title>\\n</head>\\n<body>\\n", n);
+    // markup with quoted attributes and newlines, the slashes are not escaped
+    usize end = yy_sb_get_len(sb) + len;
+    while (yy_sb_get_len(sb) < end) {
+        switch (yy_random32_uniform(4)) {
+            case 0:
+                yy_sb_printf(sb, "<div class=\\\"section\\\" id=\\\"s%u\\\">\\n", yy_random32());
+                break;
+            case 1:
+                yy_sb_printf(sb, "<a href=\\\"https://example.com/%s/%u\\\">%s</a>\\n",
+                             blob_words[yy_random32_uniform(BLOB_WORD_NUM)], yy_random32(),
+                             blob_words[yy_random32_uniform(BLOB_WORD_NUM)]);
+                break;
+            default:
+                yy_sb_append(sb, "<p class=\\\"text\\\">");
+                for (int i = 0; i < 24; i++) {
+                    yy_sb_append(sb, blob_words[yy_random32_uniform(BLOB_WORD_NUM)]);
+                    yy_sb_append(sb, " ");
+                }
+                yy_sb_append(sb, "</p>\\n");
+                break;
+        }
+    }
+    yy_sb_append(sb, "</body>\\n</html>\\n\"}");
+}
+
+const char *benchmark_blob_kind_name(blob_gen_kind kind) {
+    switch (kind) {
+        case BLOB_GEN_BASE64: return "base64";
+        case BLOB_GEN_LOG: return "log";
+        case BLOB_GEN_HTML: return "html";
+        default: return "unknown";
+    }
+}
+
+char *benchmark_gen_blob(blob_gen_kind kind, usize target_size, usize *out_size) {
+    static const char *roots[] = { "attachments", "records", "pages" };
+    if ((int)kind < 0 || kind >= BLOB_GEN_KIND_NUM) return NULL;
+    
+    yy_sb sb;
+    if (!yy_sb_init(&sb, target_size + 2 * 1024 * 1024)) return NULL;
+    yy_random_reset();
+    yy_sb_printf(&sb, "{\"%s\":[", roots[kind]);
+    for (usize n = 0; yy_sb_get_len(&sb) < target_size; n++) {
+        if (n) yy_sb_append(&sb, ",");
+        if (kind == BLOB_GEN_BASE64) blob_gen_base64(&sb, n);
+        else if (kind == BLOB_GEN_LOG) blob_gen_log(&sb, n);
+        else blob_gen_html(&sb, n);
+    }
+    yy_sb_append(&sb, "]}");
+    *out_size = yy_sb_get_len(&sb);
+    return yy_sb_get_str(&sb);
+}
+
+
+
+// -----------------------------------------------------------------------------
+// nested
+
+static void nested_add(yyjson_mut_doc *mdoc, yyjson_mut_val *arr, const char *topic,
+                       yyjson_val *child, usize *num) {
+    usize len;
+    char *payload = yyjson_val_write(child, YYJSON_WRITE_NOFLAG, &len);
+    if (!payload) return;
+    yyjson_mut_val *msg = yyjson_mut_arr_add_obj(mdoc, arr);
+    yyjson_mut_obj_add_str(mdoc, msg, "topic", topic);
+    yyjson_mut_obj_add_uint(mdoc, msg, "seq", *num);
+    yyjson_mut_obj_add_strncpy(mdoc, msg, "payload", payload, len);
+    free(payload);
+    (*num)++;
+}
+
+char *benchmark_gen_nested(const char *json, usize size, const char *topic,
+                           usize *out_count, usize *out_size) {
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return NULL;
+    
+    // one message per child of the largest container, like gen_large_container()
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    yyjson_val *ctn = NULL;
+    usize ctn_size = 0;
+    find_largest_container(root, &ctn, &ctn_size);
+    
+    yyjson_mut_doc *mdoc = yyjson_mut_doc_new(NULL);
+    yyjson_mut_val *arr = yyjson_mut_arr(mdoc);
+    yyjson_mut_doc_set_root(mdoc, arr);
+    usize idx, max, num = 0;
+    yyjson_val *k, *v;
+    if (!ctn) {
+        nested_add(mdoc, arr, topic, root, &num);
+    } else if (yyjson_is_arr(ctn)) {
+        yyjson_arr_foreach(ctn, idx, max, v) {
+            nested_add(mdoc, arr, topic, v, &num);
+        }
+    } else {
+        yyjson_obj_foreach(ctn, idx, max, k, v) {
+            nested_add(mdoc, arr, topic, v, &num);
+        }
+    }
+    
+    char *str = yyjson_mut_write(mdoc, YYJSON_WRITE_NOFLAG, out_size);
+    yyjson_mut_doc_free(mdoc);
+    yyjson_doc_free(doc);
+    *out_count = num;
+    return str;
+}
+
+
+
+// -----------------------------------------------------------------------------
+// adversarial
+
+#define ADVERSARIAL_DEPTH 100000
+#define ADVERSARIAL_KEY_NUM 1000000
+#define ADVERSARIAL_COLLISION_BITS 13
+#define ADVERSARIAL_NUMBER_DIGITS 10000
+#define ADVERSARIAL_SPACE_RUN 4096
+#define ADVERSARIAL_TARGET_SIZE (8 * 1024 * 1024)
+
+/* lookup3 hashlittle() by Bob Jenkins, reading one byte at a time, the hash
+   of the jansson hashtable */
+#define LOOKUP3_ROT(x, k) (((x) << (k)) | ((x) >> (32 - (k))))
+
+static u32 adversarial_lookup3(const u8 *k, usize len, u32 seed) {
+    u32 a, b, c;
+    a = b = c = 0xdeadbeef + (u32)len + seed;
+    while (len > 12) {
+        a += (u32)k[0] | (u32)k[1] << 8 | (u32)k[2] << 16 | (u32)k[3] << 24;
+        b += (u32)k[4] | (u32)k[5] << 8 | (u32)k[6] << 16 | (u32)k[7] << 24;
+        c += (u32)k[8] | (u32)k[9] << 8 | (u32)k[10] << 16 | (u32)k[11] << 24;
+        a -= c; a ^= LOOKUP3_ROT(c, 4);  c += b;
+        b -= a; b ^= LOOKUP3_ROT(a, 6);  a += c;
+        c -= b; c ^= LOOKUP3_ROT(b, 8);  b += a;
+        a -= c; a ^= LOOKUP3_ROT(c, 16); c += b;
+        b -= a; b ^= LOOKUP3_ROT(a, 19); a += c;
+        c -= b; c ^= LOOKUP3_ROT(b, 4);  b += a;
+        len -= 12;
+        k += 12;
+    }
+    switch (len) {
+        case 12: c += (u32)k[11] << 24; /* fallthrough */
+        case 11: c += (u32)k[10] << 16; /* fallthrough */
+        case 10: c += (u32)k[9] << 8; /* fallthrough */
+        case 9: c += k[8]; /* fallthrough */
+        case 8: b += (u32)k[7] << 24; /* fallthrough */
+        case 7: b += (u32)k[6] << 16; /* fallthrough */
+        case 6: b += (u32)k[5] << 8; /* fallthrough */
+        case 5: b += k[4]; /* fallthrough */
+        case 4: a += (u32)k[3] << 24; /* fallthrough */
+        case 3: a += (u32)k[2] << 16; /* fallthrough */
+        case 2: a += (u32)k[1] << 8; /* fallthrough */
+        case 1: a += k[0]; break;
+        default: return c;
+    }
+    c ^= b; c -= LOOKUP3_ROT(b, 14);
+    a ^= c; a -= LOOKUP3_ROT(c, 11);
+    b ^= a; b -= LOOKUP3_ROT(a, 25);
+    c ^= b; c -= LOOKUP3_ROT(b, 16);
+    a ^= c; a -= LOOKUP3_ROT(c, 4);
+    b ^= a; b -= LOOKUP3_ROT(a, 14);
+    c ^= b; c -= LOOKUP3_ROT(b, 24);
+    return c;
+}
+
+static void adversarial_gen_collision(yy_sb *sb) {
+    // jansson grows its table to one bucket per key, so the keys with the same
+    // low bits of the hash all end up in bucket 0 of the final table, and each
+    // insertion walks the whole chain
+    static const char hex[] = "0123456789abcdef";
+    u32 key_num = (u32)1 << ADVERSARIAL_COLLISION_BITS;
+    u32 mask = key_num - 1;
+    u8 key[8];
+    yy_buf_grow(sb, (usize)key_num * (sizeof(key) + 5) + 2);
+    *sb->cur++ = '{';
+    for (u32 n = 0, found = 0; found < key_num; n++) {
+        for (int i = 0; i < 8; i++) key[i] = (u8)hex[(n >> (28 - i * 4)) & 0xF];
+        if (adversarial_lookup3(key, sizeof(key), JANSSON_HASH_SEED) & mask) continue;
+        if (found++) *sb->cur++ = ',';
+        *sb->cur++ = '"';
+        memcpy(sb->cur, key, sizeof(key));
+        sb->cur += sizeof(key);
+        *sb->cur++ = '"';
+        *sb->cur++ = ':';
+        *sb->cur++ = '0';
+    }
+    *sb->cur++ = '}';
+}
+
+static void adversarial_gen_number(yy_sb *sb) {
+    // significant digits far beyond the 17 of a double, each needs a slow path
+    yy_sb_append(sb, "[");
+    for (usize n = 0; yy_sb_get_len(sb) < ADVERSARIAL_TARGET_SIZE; n++) {
+        if (n) yy_sb_append(sb, ",");
+        yy_buf_grow(sb, ADVERSARIAL_NUMBER_DIGITS + 16);
+        if (n % 2) *sb->cur++ = '-';
+        *sb->cur++ = (u8)('1' + yy_random32_uniform(9));
+        *sb->cur++ = '.';
+        for (int i = 1; i < ADVERSARIAL_NUMBER_DIGITS; i++) {
+            *sb->cur++ = (u8)('0' + yy_random32_uniform(10));
+        }
+        yy_sb_printf(sb, "e%d", (int)yy_random32_range(0, 600) - 300);
+    }
+    yy_sb_append(sb, "]");
+}
+
+static void adversarial_gen_space_run(yy_sb *sb) {
+    static const char spaces[] = " \t\n\r";
+    yy_buf_grow(sb, ADVERSARIAL_SPACE_RUN);
+    for (int i = 0; i < ADVERSARIAL_SPACE_RUN; i++) {
+        *sb->cur++ = (u8)spaces[yy_random32_uniform(4)];
+    }
+}
+
+static void adversarial_gen_whitespace(yy_sb *sb) {
+    // long runs of mixed whitespace around every token
+    adversarial_gen_space_run(sb);
+    yy_sb_append(sb, "[");
+    for (usize n = 0; yy_sb_get_len(sb) < ADVERSARIAL_TARGET_SIZE; n++) {
+        if (n) yy_sb_append(sb, ",");
+        adversarial_gen_space_run(sb);
+        yy_sb_printf(sb, "%u", yy_random32_uniform(1000));
+        adversarial_gen_space_run(sb);
+    }
+    yy_sb_append(sb, "]");
+    adversarial_gen_space_run(sb);
+}
+
+static void adversarial_gen_escape(yy_sb *sb) {
+    // one string without any unescaped character
+    static const char *escapes[] = {
+        "\\\"", "\\\\", "\\/", "\\b", "\\f", "\\n", "\\r", "\\t",
+        "\\u0000", "\\u00E9", "\\u4E2D", "\\uD83D\\uDE00"
+    };
+    yy_sb_append(sb, "[\"");
+    while (yy_sb_get_len(sb) < ADVERSARIAL_TARGET_SIZE) {
+        yy_sb_append(sb, escapes[yy_random32_uniform(sizeof(escapes) / sizeof(escapes[0]))]);
+    }
+    yy_sb_append(sb, "\"]");
+}
+
+const char *benchmark_adversarial_kind_name(adversarial_kind kind) {
+    switch (kind) {
+        case ADVERSARIAL_DEEP_ARRAY: return "deep_array";
+        case ADVERSARIAL_DEEP_OBJECT: return "deep_object";
+        case ADVERSARIAL_MANY_KEYS: return "many_keys";
+        case ADVERSARIAL_HASH_COLLISION: return "hash_collision";
+        case ADVERSARIAL_LONG_NUMBER: return "long_number";
+        case ADVERSARIAL_WHITESPACE: return "whitespace";
+        case ADVERSARIAL_ESCAPE_RUN: return "escape_run";
+        default: return "unknown";
+    }
+}
+
+char *benchmark_gen_adversarial(adversarial_kind kind, usize *out_size) {
+    if ((int)kind < 0 || kind >= ADVERSARIAL_KIND_NUM) return NULL;
+    
+    yy_sb sb;
+    if (!yy_sb_init(&sb, ADVERSARIAL_TARGET_SIZE + 64 * 1024)) return NULL;
+    yy_random_reset();
+    switch (kind) {
+        case ADVERSARIAL_DEEP_ARRAY:
+            yy_buf_grow(&sb, ADVERSARIAL_DEPTH * 2);
+            memset(sb.cur, '[', ADVERSARIAL_DEPTH);
+            memset(sb.cur + ADVERSARIAL_DEPTH, ']', ADVERSARIAL_DEPTH);
+            sb.cur += ADVERSARIAL_DEPTH * 2;
+            break;
+        case ADVERSARIAL_DEEP_OBJECT:
+            for (int i = 0; i < ADVERSARIAL_DEPTH; i++) yy_sb_append(&sb, "{\"a\":");
+            yy_sb_append(&sb, "null");
+            yy_buf_grow(&sb, ADVERSARIAL_DEPTH);
+            memset(sb.cur, '}', ADVERSARIAL_DEPTH);
+            sb.cur += ADVERSARIAL_DEPTH;
+            break;
+        case ADVERSARIAL_MANY_KEYS:
+            yy_sb_append(&sb, "{");
+            for (u32 n = 0; n < ADVERSARIAL_KEY_NUM; n++) {
+                yy_sb_printf(&sb, n ? ",\"k%u\":%u" : "\"k%u\":%u", n, n);
+            }
+            yy_sb_append(&sb, "}");
+            break;
+        case ADVERSARIAL_HASH_COLLISION:
+            adversarial_gen_collision(&sb);
+            break;
+        case ADVERSARIAL_LONG_NUMBER:
+            adversarial_gen_number(&sb);
+            break;
+        case ADVERSARIAL_WHITESPACE:
+            adversarial_gen_whitespace(&sb);
+            break;
+        default:
+            adversarial_gen_escape(&sb);
+            break;
+    }
+    *out_size = yy_sb_get_len(&sb);
+    return yy_sb_get_str(&sb);
+}
@@ -0,0 +1,168 @@
+#include "benchmark.h"
+
+
+/*
+ Run a reader in a forked child, so the inputs that crash or hang a library
+ (stack overflow on deep nesting, quadratic paths) are reported instead of
+ stopping the benchmark. The child has an interval timer and an address space
+ limit, and sends the result back through a pipe; a child killed by SIGALRM
+ is a timeout, any other abnormal exit is a crash.
+
+ The peak memory is the growth of the child's max RSS during the call, the
+ pages shared with the parent after fork() are not counted.
+
+ There is no fork() on Windows and iOS, the reader is called in this process.
+ */
+
+#if defined(__APPLE__)
+#   include <TargetConditionals.h>
+#endif
+
+#if (defined(__unix__) || defined(__APPLE__)) && \
+    !(defined(TARGET_OS_IPHONE) && TARGET_OS_IPHONE)
+#   define SANDBOX_FORK 1
+#   include <errno.h>
+#   include <signal.h>
+#   include <unistd.h>
+#   include <sys/resource.h>
+#   include <sys/time.h>
+#   include <sys/wait.h>
+#endif
+
+const char *benchmark_sandbox_status_name(sandbox_status status) {
+    switch (status) {
+        case SANDBOX_ACCEPT: return "accept";
+        case SANDBOX_REJECT: return "reject";
+        case SANDBOX_CRASH: return "crash";
+        case SANDBOX_TIMEOUT: return "timeout";
+        default: return "unknown";
+    }
+}
+
+#if SANDBOX_FORK
+
+typedef struct {
+    bool accept;
+    f64 seconds;
+    usize mem;
+} sandbox_message;
+
+static usize sandbox_max_rss(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return (usize)usage.ru_maxrss; /* bytes */
+#else
+    return (usize)usage.ru_maxrss * 1024; /* kilobytes */
+#endif
+}
+
+static void sandbox_set_mem_limit(usize mem_limit) {
+    if (!mem_limit) return;
+    usize base = 0;
+#if defined(__linux__)
+    // the limit is on the whole address space, count the mappings of the parent
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file) {
+        unsigned long pages = 0;
+        if (fscanf(file, "%lu", &pages) == 1) base = (usize)pages * (usize)sysconf(_SC_PAGESIZE);
+        fclose(file);
+    }
+#endif
+    struct rlimit limit;
+    limit.rlim_cur = limit.rlim_max = (rlim_t)(base + mem_limit);
+    setrlimit(RLIMIT_AS, &limit);
+}
+
+static void sandbox_child(int fd, reader_measure_func func, const char *json,
+                          size_t size, f64 timeout, usize mem_limit) {
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    timer.it_value.tv_sec = (time_t)timeout;
+    timer.it_value.tv_usec = (suseconds_t)((timeout - (f64)(time_t)timeout) * 1000000.0);
+    signal(SIGALRM, SIG_DFL);
+    setitimer(ITIMER_REAL, &timer, NULL);
+    sandbox_set_mem_limit(mem_limit);
+    
+    sandbox_message msg;
+    usize rss = sandbox_max_rss();
+    f64 begin = yy_time_get_seconds();
+    msg.accept = false;
+    func(json, size, &msg.accept, 1);
+    msg.seconds = yy_time_get_seconds() - begin;
+    msg.mem = sandbox_max_rss() - rss;
+    
+    // no atexit handlers or stdio buffers of the parent
+    bool suc = write(fd, &msg, sizeof(msg)) == (ssize_t)sizeof(msg);
+    _exit(suc ? 0 : 1);
+}
+
+bool benchmark_sandbox_supported(void) {
+    return true;
+}
+
+sandbox_result benchmark_sandbox_read(reader_measure_func func, const char *json,
+                                      size_t size, f64 timeout, usize mem_limit) {
+    sandbox_result res;
+    memset(&res, 0, sizeof(res));
+    res.status = SANDBOX_CRASH;
+    
+    int fds[2];
+    if (pipe(fds) != 0) return res;
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return res;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        sandbox_child(fds[1], func, json, size, timeout, mem_limit);
+    }
+    close(fds[1]);
+    
+    int wstatus = 0;
+    while (waitpid(pid, &wstatus, 0) < 0) {
+        if (errno != EINTR) {
+            close(fds[0]);
+            return res;
+        }
+    }
+    sandbox_message msg;
+    bool has_msg = read(fds[0], &msg, sizeof(msg)) == (ssize_t)sizeof(msg);
+    close(fds[0]);
+    
+    if (WIFSIGNALED(wstatus) && WTERMSIG(wstatus) == SIGALRM) {
+        res.status = SANDBOX_TIMEOUT;
+        res.seconds = timeout;
+    } else if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0 && has_msg) {
+        res.status = msg.accept ? SANDBOX_ACCEPT : SANDBOX_REJECT;
+        res.seconds = msg.seconds;
+        res.mem = msg.mem;
+    }
+    return res;
+}
+
+#else
+
+bool benchmark_sandbox_supported(void) {
+    return false;
+}
+
+sandbox_result benchmark_sandbox_read(reader_measure_func func, const char *json,
+                                      size_t size, f64 timeout, usize mem_limit) {
+    (void)timeout;
+    (void)mem_limit;
+    sandbox_result res;
+    memset(&res, 0, sizeof(res));
+    bool valid = false;
+    f64 begin = yy_time_get_seconds();
+    func(json, size, &valid, 1);
+    res.status = valid ? SANDBOX_ACCEPT : SANDBOX_REJECT;
+    res.seconds = yy_time_get_seconds() - begin;
+    return res;
+}
+
+#endif
@@ -0,0 +1,337 @@
+#include "benchmark.h"
+
+
+/*
+ A minimal JSON Patch (RFC 6902) and JSON Merge Patch (RFC 7386)
+ implementation, shared by the libraries without native patch support.
+ The document is patched in place through the library's mutable DOM, the
+ paths are parsed with the shared JSON Pointer parser.
+
+ The values returned by the adapter point into the DOM, they may be moved by
+ a later mutation of their container, so every op walks its paths again
+ after the document has been changed.
+ */
+
+#define PATCH_MAX_TOKENS 64
+#define PATCH_STACK_BUF 512
+
+typedef struct {
+    json_ptr_token tokens[PATCH_MAX_TOKENS];
+    usize count;
+    char *buf;
+    char stack[PATCH_STACK_BUF];
+} patch_ptr;
+
+static bool patch_ptr_parse(patch_ptr *ptr, const char *str, usize len) {
+    ptr->buf = len < PATCH_STACK_BUF ? ptr->stack : malloc(len + 1);
+    if (!ptr->buf) return false;
+    ptr->count = json_pointer_parse(str, len, ptr->buf, ptr->tokens, PATCH_MAX_TOKENS);
+    return ptr->count != SIZE_MAX;
+}
+
+static void patch_ptr_release(patch_ptr *ptr) {
+    if (ptr->buf && ptr->buf != ptr->stack) free(ptr->buf);
+    ptr->buf = NULL;
+}
+
+static void *patch_get_child(const json_patch_adapter *adp, void *ctn,
+                             const json_ptr_token *token) {
+    json_path_type type = adp->get_type(ctn);
+    if (type == JSON_PATH_OBJ) {
+        return adp->obj_get(ctn, token->str, token->len);
+    }
+    if (type == JSON_PATH_ARR) {
+        usize idx;
+        if (!json_pointer_token_to_index(token, &idx)) return NULL;
+        if (idx >= adp->size(ctn)) return NULL;
+        return adp->arr_get(ctn, idx);
+    }
+    return NULL;
+}
+
+/* Walk the first `count` tokens of the pointer. */
+static void *patch_walk(const json_patch_adapter *adp, void *root,
+                        const patch_ptr *ptr, usize count) {
+    void *val = root;
+    for (usize i = 0; i < count && val; i++) {
+        val = patch_get_child(adp, val, ptr->tokens + i);
+    }
+    return val;
+}
+
+static const char *patch_get_member_str(const json_patch_adapter *adp, void *op,
+                                        const char *key, usize *len) {
+    void *val = adp->obj_get(op, key, strlen(key));
+    if (!val || adp->get_type(val) != JSON_PATH_STR) return NULL;
+    return adp->get_str(val, len);
+}
+
+
+
+/*==============================================================================
+ * Equality
+ *============================================================================*/
+
+static bool patch_equals(const json_patch_adapter *adp, void *lhs, void *rhs);
+
+typedef struct {
+    const json_patch_adapter *adp;
+    void *other;
+    bool equal;
+} patch_equals_ctx;
+
+static bool patch_equals_member(void *ctx_ptr, const char *key, usize key_len, void *val) {
+    patch_equals_ctx *ctx = (patch_equals_ctx *)ctx_ptr;
+    void *other = ctx->adp->obj_get(ctx->other, key, key_len);
+    if (!other || !patch_equals(ctx->adp, val, other)) {
+        ctx->equal = false;
+        return false;
+    }
+    return true;
+}
+
+static bool patch_equals(const json_patch_adapter *adp, void *lhs, void *rhs) {
+    json_path_type type = adp->get_type(lhs);
+    if (type != adp->get_type(rhs)) return false;
+    switch (type) {
+        case JSON_PATH_NULL:
+            return true;
+        case JSON_PATH_BOOL:
+            return adp->get_bool(lhs) == adp->get_bool(rhs);
+        case JSON_PATH_NUM:
+            return adp->get_num(lhs) == adp->get_num(rhs);
+        case JSON_PATH_STR: {
+            usize lhs_len, rhs_len;
+            const char *lhs_str = adp->get_str(lhs, &lhs_len);
+            const char *rhs_str = adp->get_str(rhs, &rhs_len);
+            return lhs_len == rhs_len && memcmp(lhs_str, rhs_str, lhs_len) == 0;
+        }
+        case JSON_PATH_ARR: {
+            usize size = adp->size(lhs);
+            if (size != adp->size(rhs)) return false;
+            for (usize i = 0; i < size; i++) {
+                if (!patch_equals(adp, adp->arr_get(lhs, i), adp->arr_get(rhs, i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case JSON_PATH_OBJ: {
+            if (adp->size(lhs) != adp->size(rhs)) return false;
+            patch_equals_ctx ctx;
+            ctx.adp = adp;
+            ctx.other = rhs;
+            ctx.equal = true;
+            adp->obj_foreach(lhs, patch_equals_member, &ctx);
+            return ctx.equal;
+        }
+        default:
+            return false;
+    }
+}
+
+
+
+/*==============================================================================
+ * JSON Patch
+ *============================================================================*/
+
+/* Insert a detached value at the pointer, the value is released on failure. */
+static bool patch_add(const json_patch_adapter *adp, void *root,
+                      const patch_ptr *ptr, void *val) {
+    void *parent = NULL;
+    const json_ptr_token *last;
+    usize idx;
+
+    /* replace the root is not supported */
+    if (ptr->count > 0) parent = patch_walk(adp, root, ptr, ptr->count - 1);
+    if (parent) {
+        last = ptr->tokens + ptr->count - 1;
+        switch (adp->get_type(parent)) {
+            case JSON_PATH_OBJ:
+                if (adp->obj_put(adp->ctx, parent, last->str, last->len, val)) return true;
+                break;
+            case JSON_PATH_ARR:
+                if (last->len == 1 && last->str[0] == '-') idx = adp->size(parent);
+                else if (!json_pointer_token_to_index(last, &idx)) break;
+                if (idx > adp->size(parent)) break;
+                if (adp->arr_insert(adp->ctx, parent, idx, val)) return true;
+                break;
+            default:
+                break;
+        }
+    }
+    adp->release(adp->ctx, val);
+    return false;
+}
+
+/* Detach the value at the pointer, returns NULL if not found. */
+static void *patch_remove(const json_patch_adapter *adp, void *root,
+                          const patch_ptr *ptr) {
+    if (ptr->count == 0) return NULL; /* remove the root is not supported */
+    void *parent = patch_walk(adp, root, ptr, ptr->count - 1);
+    const json_ptr_token *last = ptr->tokens + ptr->count - 1;
+    if (!parent) return NULL;
+
+    json_path_type type = adp->get_type(parent);
+    if (type == JSON_PATH_OBJ) {
+        return adp->obj_remove(adp->ctx, parent, last->str, last->len);
+    } else if (type == JSON_PATH_ARR) {
+        usize idx;
+        if (!json_pointer_token_to_index(last, &idx)) return NULL;
+        if (idx >= adp->size(parent)) return NULL;
+        return adp->arr_remove(adp->ctx, parent, idx);
+    }
+    return NULL;
+}
+
+/* Whether `ptr` is a proper descendant of `from`. */
+static bool patch_is_descendant(const patch_ptr *ptr, const patch_ptr *from) {
+    if (ptr->count <= from->count) return false;
+    for (usize i = 0; i < from->count; i++) {
+        const json_ptr_token *a = ptr->tokens + i, *b = from->tokens + i;
+        if (a->len != b->len || memcmp(a->str, b->str, a->len) != 0) return false;
+    }
+    return true;
+}
+
+static bool patch_apply_op(const json_patch_adapter *adp, void *root, void *op,
+                           patch_ptr *path, patch_ptr *from) {
+    usize op_len, path_len, from_len;
+    const char *op_str, *path_str, *from_str;
+    void *val;
+
+    if (adp->get_type(op) != JSON_PATH_OBJ) return false;
+    op_str = patch_get_member_str(adp, op, "op", &op_len);
+    path_str = patch_get_member_str(adp, op, "path", &path_len);
+    if (!op_str || !path_str) return false;
+    if (!patch_ptr_parse(path, path_str, path_len)) return false;
+
+#define op_is(name) (op_len == sizeof(name) - 1 && memcmp(op_str, name, op_len) == 0)
+
+    if (op_is("add") || op_is("replace") || op_is("test")) {
+        val = adp->obj_get(op, "value", 5);
+        if (!val) return false;
+        if (op_is("test")) {
+            void *cur = patch_walk(adp, root, path, path->count);
+            return cur && patch_equals(adp, cur, val);
+        }
+        if (op_is("replace")) {
+            void *old = patch_remove(adp, root, path);
+            if (!old) return false;
+            adp->release(adp->ctx, old);
+        }
+        val = adp->dup(adp->ctx, val);
+        return val && patch_add(adp, root, path, val);
+    }
+
+    if (op_is("remove")) {
+        val = patch_remove(adp, root, path);
+        if (!val) return false;
+        adp->release(adp->ctx, val);
+        return true;
+    }
+
+    if (op_is("move") || op_is("copy")) {
+        from_str = patch_get_member_str(adp, op, "from", &from_len);
+        if (!from_str) return false;
+        if (!patch_ptr_parse(from, from_str, from_len)) return false;
+        if (op_is("copy")) {
+            val = patch_walk(adp, root, from, from->count);
+            val = val ? adp->dup(adp->ctx, val) : NULL;
+        } else {
+            if (patch_is_descendant(path, from)) return false;
+            val = patch_remove(adp, root, from);
+        }
+        return val && patch_add(adp, root, path, val);
+    }
+
+#undef op_is
+
+    return false;
+}
+
+bool json_patch_apply(const json_patch_adapter *adp, void *root, void *patch) {
+    if (!adp || !root || !patch) return false;
+    if (adp->get_type(patch) != JSON_PATH_ARR) return false;
+
+    usize size = adp->size(patch);
+    for (usize i = 0; i < size; i++) {
+        patch_ptr path, from;
+        path.buf = NULL;
+        from.buf = NULL;
+        bool suc = patch_apply_op(adp, root, adp->arr_get(patch, i), &path, &from);
+        patch_ptr_release(&path);
+        patch_ptr_release(&from);
+        if (!suc) return false;
+    }
+    return true;
+}
+
+
+
+/*==============================================================================
+ * JSON Merge Patch
+ *============================================================================*/
+
+typedef struct {
+    const json_patch_adapter *adp;
+    void *target;
+    bool suc;
+} merge_ctx;
+
+static bool merge_patch_obj(const json_patch_adapter *adp, void *target, void *patch);
+
+static bool merge_patch_member(void *ctx_ptr, const char *key, usize key_len, void *val) {
+    merge_ctx *ctx = (merge_ctx *)ctx_ptr;
+    const json_patch_adapter *adp = ctx->adp;
+    json_path_type type = adp->get_type(val);
+
+    if (type == JSON_PATH_NULL) {
+        void *old = adp->obj_remove(adp->ctx, ctx->target, key, key_len);
+        if (old) adp->release(adp->ctx, old);
+        return true;
+    }
+    if (type == JSON_PATH_OBJ) {
+        void *cur = adp->obj_get(ctx->target, key, key_len);
+        if (!cur || adp->get_type(cur) != JSON_PATH_OBJ) {
+            void *obj = adp->new_obj(adp->ctx);
+            if (!obj || !adp->obj_put(adp->ctx, ctx->target, key, key_len, obj)) {
+                if (obj) adp->release(adp->ctx, obj);
+                ctx->suc = false;
+                return false;
+            }
+            cur = adp->obj_get(ctx->target, key, key_len);
+        }
+        if (!cur || !merge_patch_obj(adp, cur, val)) {
+            ctx->suc = false;
+            return false;
+        }
+        return true;
+    }
+
+    void *dup = adp->dup(adp->ctx, val);
+    if (!dup || !adp->obj_put(adp->ctx, ctx->target, key, key_len, dup)) {
+        if (dup) adp->release(adp->ctx, dup);
+        ctx->suc = false;
+        return false;
+    }
+    return true;
+}
+
+static bool merge_patch_obj(const json_patch_adapter *adp, void *target, void *patch) {
+    merge_ctx ctx;
+    ctx.adp = adp;
+    ctx.target = target;
+    ctx.suc = true;
+    adp->obj_foreach(patch, merge_patch_member, &ctx);
+    return ctx.suc;
+}
+
+bool json_merge_patch_apply(const json_patch_adapter *adp, void *root, void *patch) {
+    if (!adp || !root || !patch) return false;
+    /* a non-object patch replaces the whole document, which is not supported */
+    if (adp->get_type(root) != JSON_PATH_OBJ) return false;
+    if (adp->get_type(patch) != JSON_PATH_OBJ) return false;
+    return merge_patch_obj(adp, root, patch);
+}
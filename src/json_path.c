@@ -0,0 +1,440 @@
+#include "benchmark.h"
+
+
+/*
+ A small JSONPath engine for query benchmark.
+
+ Supported syntax (a subset of RFC 9535):
+    $                   root
+    .name ['name']      member
+    .* [*]              all members or elements
+    ..                  descendant (followed by name, * or bracket)
+    [n]                 array index, negative from the end
+    [start:end:step]    array slice
+    [?(@.name op lit)]  filter, op: == != < <= > >=, lit: string, number,
+                        true, false or null; [?(@.name)] tests existence,
+                        and `@` without name tests the value itself
+
+ The path is evaluated on any DOM through `json_path_adapter`, so all the
+ libraries run the same engine and only the DOM access differs.
+ */
+
+
+
+/*==============================================================================
+ * Compile
+ *============================================================================*/
+
+#define PATH_MAX_STEPS 63
+
+static yy_inline bool path_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static yy_inline bool path_is_name(char c) {
+    return c != '.' && c != '[' && c != ']' && c != '\0' && !path_is_space(c);
+}
+
+static const char *path_skip_space(const char *cur, const char *end) {
+    while (cur < end && path_is_space(*cur)) cur++;
+    return cur;
+}
+
+/* Parse a quoted string without escape, returns the position after the quote. */
+static const char *path_parse_quoted(const char *cur, const char *end,
+                                     const char **str, usize *len) {
+    char quote = *cur++;
+    const char *beg = cur;
+    while (cur < end && *cur != quote) cur++;
+    if (cur == end) return NULL;
+    *str = beg;
+    *len = (usize)(cur - beg);
+    return cur + 1;
+}
+
+static const char *path_parse_int(const char *cur, const char *end, i64 *val, bool *has) {
+    bool neg = false;
+    i64 num = 0;
+    *has = false;
+    cur = path_skip_space(cur, end);
+    if (cur < end && *cur == '-') {
+        neg = true;
+        cur++;
+    }
+    while (cur < end && *cur >= '0' && *cur <= '9') {
+        num = num * 10 + (*cur++ - '0');
+        *has = true;
+    }
+    if (neg && !*has) return NULL;
+    *val = neg ? -num : num;
+    return path_skip_space(cur, end);
+}
+
+static const char *path_parse_filter(const char *cur, const char *end, json_path_step *step) {
+    step->type = JSON_PATH_STEP_FILTER;
+    cur = path_skip_space(cur, end);
+    if (cur == end || *cur++ != '@') return NULL;
+
+    // member of `@`
+    if (cur < end && *cur == '.') {
+        step->name = ++cur;
+        while (cur < end && path_is_name(*cur) && *cur != ')' &&
+               *cur != '=' && *cur != '!' && *cur != '<' && *cur != '>') cur++;
+        step->name_len = (usize)(cur - step->name);
+        if (step->name_len == 0) return NULL;
+    } else if (cur + 1 < end && *cur == '[' && (cur[1] == '\'' || cur[1] == '"')) {
+        cur = path_parse_quoted(cur + 1, end, &step->name, &step->name_len);
+        if (!cur || cur == end || *cur++ != ']') return NULL;
+    }
+    cur = path_skip_space(cur, end);
+    if (cur == end) return NULL;
+
+    // operator
+    if (*cur == ')') {
+        step->op = JSON_PATH_OP_EXISTS;
+        return cur + 1;
+    }
+    if (cur + 1 < end && cur[0] == '=' && cur[1] == '=') step->op = JSON_PATH_OP_EQ;
+    else if (cur + 1 < end && cur[0] == '!' && cur[1] == '=') step->op = JSON_PATH_OP_NE;
+    else if (cur + 1 < end && cur[0] == '<' && cur[1] == '=') step->op = JSON_PATH_OP_LE;
+    else if (cur + 1 < end && cur[0] == '>' && cur[1] == '=') step->op = JSON_PATH_OP_GE;
+    else if (cur[0] == '<') step->op = JSON_PATH_OP_LT;
+    else if (cur[0] == '>') step->op = JSON_PATH_OP_GT;
+    else return NULL;
+    cur += (step->op == JSON_PATH_OP_LT || step->op == JSON_PATH_OP_GT) ? 1 : 2;
+    cur = path_skip_space(cur, end);
+    if (cur == end) return NULL;
+
+    // literal
+    if (*cur == '\'' || *cur == '"') {
+        step->lit_type = JSON_PATH_STR;
+        cur = path_parse_quoted(cur, end, &step->lit_str, &step->lit_len);
+        if (!cur) return NULL;
+    } else if ((usize)(end - cur) >= 4 && memcmp(cur, "true", 4) == 0) {
+        step->lit_type = JSON_PATH_BOOL;
+        step->lit_bool = true;
+        cur += 4;
+    } else if ((usize)(end - cur) >= 5 && memcmp(cur, "false", 5) == 0) {
+        step->lit_type = JSON_PATH_BOOL;
+        step->lit_bool = false;
+        cur += 5;
+    } else if ((usize)(end - cur) >= 4 && memcmp(cur, "null", 4) == 0) {
+        step->lit_type = JSON_PATH_NULL;
+        cur += 4;
+    } else {
+        char buf[64], *num_end;
+        usize len = 0;
+        while (cur + len < end && len < sizeof(buf) - 1 && cur[len] != ')' &&
+               !path_is_space(cur[len])) {
+            buf[len] = cur[len];
+            len++;
+        }
+        buf[len] = '\0';
+        step->lit_type = JSON_PATH_NUM;
+        step->lit_num = strtod(buf, &num_end);
+        if (len == 0 || num_end != buf + len) return NULL;
+        cur += len;
+    }
+    cur = path_skip_space(cur, end);
+    if (cur == end || *cur != ')') return NULL;
+    return cur + 1;
+}
+
+static const char *path_parse_bracket(const char *cur, const char *end, json_path_step *step) {
+    cur = path_skip_space(cur, end);
+    if (cur == end) return NULL;
+    if (*cur == '*') {
+        step->type = JSON_PATH_STEP_WILDCARD;
+        cur++;
+    } else if (*cur == '\'' || *cur == '"') {
+        step->type = JSON_PATH_STEP_NAME;
+        cur = path_parse_quoted(cur, end, &step->name, &step->name_len);
+    } else if (*cur == '?') {
+        cur = path_skip_space(cur + 1, end);
+        if (cur == end || *cur != '(') return NULL;
+        cur = path_parse_filter(cur + 1, end, step);
+    } else {
+        bool has;
+        cur = path_parse_int(cur, end, &step->start, &step->has_start);
+        if (!cur || cur == end) return NULL;
+        if (*cur != ':') {
+            if (!step->has_start) return NULL;
+            step->type = JSON_PATH_STEP_INDEX;
+        } else {
+            step->type = JSON_PATH_STEP_SLICE;
+            cur = path_parse_int(cur + 1, end, &step->end, &step->has_end);
+            if (cur && cur < end && *cur == ':') {
+                cur = path_parse_int(cur + 1, end, &step->step, &has);
+                if (cur && !has) step->step = 1;
+            } else {
+                step->step = 1;
+            }
+        }
+    }
+    if (!cur) return NULL;
+    cur = path_skip_space(cur, end);
+    if (cur == end || *cur != ']') return NULL;
+    return cur + 1;
+}
+
+json_path *json_path_compile(const char *str, usize len) {
+    json_path *path = calloc(1, sizeof(json_path));
+    if (!path) return NULL;
+    path->steps = calloc(PATH_MAX_STEPS, sizeof(json_path_step));
+    path->str = malloc(len + 1);
+    if (!path->steps || !path->str) goto fail;
+    memcpy(path->str, str, len);
+    path->str[len] = '\0';
+
+    const char *cur = path->str, *end = path->str + len;
+    if (cur == end || *cur++ != '$') goto fail;
+    while (cur < end) {
+        if (path->count == PATH_MAX_STEPS) goto fail;
+        json_path_step *step = path->steps + path->count++;
+        if (*cur == '.') {
+            cur++;
+            if (cur < end && *cur == '.') {
+                step->descendant = true;
+                cur++;
+                if (cur < end && *cur == '[') {
+                    cur = path_parse_bracket(cur + 1, end, step);
+                    if (!cur) goto fail;
+                    continue;
+                }
+            }
+            if (cur < end && *cur == '*') {
+                step->type = JSON_PATH_STEP_WILDCARD;
+                cur++;
+                continue;
+            }
+            step->type = JSON_PATH_STEP_NAME;
+            step->name = cur;
+            while (cur < end && path_is_name(*cur)) cur++;
+            step->name_len = (usize)(cur - step->name);
+            if (step->name_len == 0) goto fail;
+        } else if (*cur == '[') {
+            cur = path_parse_bracket(cur + 1, end, step);
+            if (!cur) goto fail;
+        } else {
+            goto fail;
+        }
+    }
+
+    // the whole string is parsed, terminate the names and literals in place
+    for (usize i = 0; i < path->count; i++) {
+        json_path_step *step = path->steps + i;
+        if (step->name) ((char *)step->name)[step->name_len] = '\0';
+        if (step->lit_str) ((char *)step->lit_str)[step->lit_len] = '\0';
+    }
+    return path;
+
+fail:
+    json_path_free(path);
+    return NULL;
+}
+
+void json_path_free(json_path *path) {
+    if (!path) return;
+    free(path->steps);
+    free(path->str);
+    free(path);
+}
+
+
+
+/*==============================================================================
+ * Evaluate
+ *============================================================================*/
+
+bool json_path_filter_match(const json_path_step *step, json_path_type type,
+                            bool b, f64 num, const char *str, usize len) {
+    int cmp;
+    if (type == JSON_PATH_NONE) return false;
+    if (step->op == JSON_PATH_OP_EXISTS) return true;
+    if (type != step->lit_type) return step->op == JSON_PATH_OP_NE;
+
+    switch (type) {
+        case JSON_PATH_NULL:
+            cmp = 0;
+            break;
+        case JSON_PATH_BOOL:
+            cmp = (int)b - (int)step->lit_bool;
+            break;
+        case JSON_PATH_NUM:
+            cmp = num < step->lit_num ? -1 : (num > step->lit_num ? 1 : 0);
+            break;
+        case JSON_PATH_STR: {
+            usize min = len < step->lit_len ? len : step->lit_len;
+            cmp = memcmp(str, step->lit_str, min);
+            if (cmp == 0) cmp = len < step->lit_len ? -1 : (len > step->lit_len ? 1 : 0);
+            break;
+        }
+        default:
+            return false;
+    }
+
+    switch (step->op) {
+        case JSON_PATH_OP_EQ: return cmp == 0;
+        case JSON_PATH_OP_NE: return cmp != 0;
+        case JSON_PATH_OP_LT: return cmp < 0;
+        case JSON_PATH_OP_LE: return cmp <= 0;
+        case JSON_PATH_OP_GT: return cmp > 0;
+        case JSON_PATH_OP_GE: return cmp >= 0;
+        default: return false;
+    }
+}
+
+typedef struct {
+    const json_path *path;
+    const json_path_adapter *adp;
+    usize found;
+} path_eval_ctx;
+
+typedef struct {
+    path_eval_ctx *ctx;
+    usize idx;      /* step index */
+    i64 elem_idx;   /* element index for slice */
+    i64 lower, upper;
+} path_each_ctx;
+
+static void path_eval(path_eval_ctx *ctx, usize idx, json_path_val val);
+static void path_eval_descendant(path_eval_ctx *ctx, usize idx, json_path_val val);
+
+static bool path_filter_test(path_eval_ctx *ctx, const json_path_step *step, json_path_val val) {
+    const json_path_adapter *adp = ctx->adp;
+    json_path_val sub = val;
+    if (step->name) {
+        if (adp->get_type(val) != JSON_PATH_OBJ) return false;
+        if (!adp->obj_get(val, step->name, step->name_len, &sub)) return false;
+    }
+    json_path_type type = adp->get_type(sub);
+    bool b = false;
+    f64 num = 0;
+    const char *str = NULL;
+    usize len = 0;
+    if (step->op != JSON_PATH_OP_EXISTS) {
+        if (type == JSON_PATH_BOOL) b = adp->get_bool(sub);
+        else if (type == JSON_PATH_NUM) num = adp->get_num(sub);
+        else if (type == JSON_PATH_STR) str = adp->get_str(sub, &len);
+    }
+    return json_path_filter_match(step, type, b, num, str, len);
+}
+
+static void path_each_select(void *ptr, const char *key, usize key_len, json_path_val val) {
+    (void)key;
+    (void)key_len;
+    path_each_ctx *each = (path_each_ctx *)ptr;
+    path_eval_ctx *ctx = each->ctx;
+    const json_path_step *step = ctx->path->steps + each->idx;
+    switch (step->type) {
+        case JSON_PATH_STEP_WILDCARD:
+            path_eval(ctx, each->idx + 1, val);
+            break;
+        case JSON_PATH_STEP_SLICE: {
+            i64 i = each->elem_idx++;
+            if (i >= each->lower && i < each->upper && (i - each->lower) % step->step == 0) {
+                path_eval(ctx, each->idx + 1, val);
+            }
+            break;
+        }
+        case JSON_PATH_STEP_FILTER:
+            if (path_filter_test(ctx, step, val)) path_eval(ctx, each->idx + 1, val);
+            break;
+        default:
+            break;
+    }
+}
+
+static void path_each_descendant(void *ptr, const char *key, usize key_len, json_path_val val) {
+    (void)key;
+    (void)key_len;
+    path_each_ctx *each = (path_each_ctx *)ptr;
+    path_eval_descendant(each->ctx, each->idx, val);
+}
+
+/* Apply step `idx` to the value, and evaluate the next step on the result. */
+static void path_apply(path_eval_ctx *ctx, usize idx, json_path_val val) {
+    const json_path_adapter *adp = ctx->adp;
+    const json_path_step *step = ctx->path->steps + idx;
+    json_path_type type = adp->get_type(val);
+    json_path_val sub;
+    path_each_ctx each;
+
+    if (type != JSON_PATH_OBJ && type != JSON_PATH_ARR) return;
+    each.ctx = ctx;
+    each.idx = idx;
+    each.elem_idx = 0;
+
+    switch (step->type) {
+        case JSON_PATH_STEP_NAME:
+            if (type == JSON_PATH_OBJ && adp->obj_get(val, step->name, step->name_len, &sub)) {
+                path_eval(ctx, idx + 1, sub);
+            }
+            break;
+        case JSON_PATH_STEP_INDEX:
+            if (type == JSON_PATH_ARR) {
+                i64 i = step->start;
+                if (i < 0) i += (i64)adp->arr_size(val);
+                if (i >= 0 && adp->arr_get(val, (usize)i, &sub)) path_eval(ctx, idx + 1, sub);
+            }
+            break;
+        case JSON_PATH_STEP_SLICE:
+            if (type == JSON_PATH_ARR && step->step != 0) {
+                i64 len = (i64)adp->arr_size(val);
+                i64 start = step->start, end = step->end, s = step->step;
+                if (s > 0) {
+                    start = step->has_start ? (start < 0 ? start + len : start) : 0;
+                    end = step->has_end ? (end < 0 ? end + len : end) : len;
+                    each.lower = start < 0 ? 0 : (start > len ? len : start);
+                    each.upper = end < 0 ? 0 : (end > len ? len : end);
+                    if (each.lower < each.upper) adp->foreach(val, path_each_select, &each);
+                } else {
+                    // reverse order, use index access
+                    start = step->has_start ? (start < 0 ? start + len : start) : len - 1;
+                    end = step->has_end ? (end < 0 ? end + len : end) : -len - 1;
+                    i64 upper = start < -1 ? -1 : (start > len - 1 ? len - 1 : start);
+                    i64 lower = end < -1 ? -1 : (end > len - 1 ? len - 1 : end);
+                    for (i64 i = upper; i > lower; i += s) {
+                        if (adp->arr_get(val, (usize)i, &sub)) path_eval(ctx, idx + 1, sub);
+                    }
+                }
+            }
+            break;
+        case JSON_PATH_STEP_WILDCARD:
+        case JSON_PATH_STEP_FILTER:
+            adp->foreach(val, path_each_select, &each);
+            break;
+    }
+}
+
+/* Apply step `idx` to the value and all its descendants. */
+static void path_eval_descendant(path_eval_ctx *ctx, usize idx, json_path_val val) {
+    json_path_type type = ctx->adp->get_type(val);
+    if (type != JSON_PATH_OBJ && type != JSON_PATH_ARR) return;
+    path_apply(ctx, idx, val);
+
+    path_each_ctx each;
+    each.ctx = ctx;
+    each.idx = idx;
+    ctx->adp->foreach(val, path_each_descendant, &each);
+}
+
+static void path_eval(path_eval_ctx *ctx, usize idx, json_path_val val) {
+    if (idx == ctx->path->count) {
+        ctx->found++;
+    } else if (ctx->path->steps[idx].descendant) {
+        path_eval_descendant(ctx, idx, val);
+    } else {
+        path_apply(ctx, idx, val);
+    }
+}
+
+usize json_path_eval(const json_path *path, const json_path_adapter *adapter,
+                     json_path_val root) {
+    path_eval_ctx ctx;
+    ctx.path = path;
+    ctx.adp = adapter;
+    ctx.found = 0;
+    path_eval(&ctx, 0, root);
+    return ctx.found;
+}
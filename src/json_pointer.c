@@ -0,0 +1,52 @@
+#include "benchmark.h"
+
+
+/*
+ A minimal JSON Pointer (RFC 6901) parser, shared by the libraries without
+ native pointer support. The pointer is split into tokens with `~1` and `~0`
+ unescaped, then each library walks its own DOM with the tokens.
+ */
+
+usize json_pointer_parse(const char *ptr, usize len, char *buf,
+                         json_ptr_token *tokens, usize max) {
+    const char *cur = ptr, *end = ptr + len;
+    usize num = 0;
+
+    if (len == 0) return 0; /* whole document */
+    if (*cur != '/') return SIZE_MAX;
+
+    while (cur < end) {
+        if (num == max) return SIZE_MAX;
+        cur++; /* skip '/' */
+        tokens[num].str = buf;
+        while (cur < end && *cur != '/') {
+            if (*cur == '~') {
+                if (cur + 1 == end) return SIZE_MAX;
+                if (cur[1] == '0') *buf++ = '~';
+                else if (cur[1] == '1') *buf++ = '/';
+                else return SIZE_MAX;
+                cur += 2;
+            } else {
+                *buf++ = *cur++;
+            }
+        }
+        tokens[num].len = (usize)(buf - tokens[num].str);
+        *buf++ = '\0';
+        num++;
+    }
+    return num;
+}
+
+bool json_pointer_token_to_index(const json_ptr_token *token, usize *idx) {
+    const char *str = token->str;
+    usize len = token->len, val = 0;
+
+    if (len == 0 || len > 19) return false;
+    if (str[0] == '0' && len > 1) return false; /* leading zero */
+    for (usize i = 0; i < len; i++) {
+        if (str[i] < '0' || str[i] > '9') return false;
+        val = val * 10 + (usize)(str[i] - '0');
+    }
+    *idx = val;
+    return true;
+}
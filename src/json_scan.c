@@ -0,0 +1,379 @@
+#include "benchmark.h"
+
+
+/*
+ A structural index scanner, similar to the first stage of simdjson.
+
+ The input is processed in 64-byte blocks. Each instruction set classifies the
+ bytes of a block into 64-bit masks (quote, backslash, operator, whitespace and
+ control characters), then the masks are combined with plain bit operations:
+
+   escaped:   the byte after an odd-length backslash run
+   quote:     quote & ~escaped
+   in_string: prefix xor of the quotes, from the opening quote (included) to
+              the closing quote (excluded), carried to the next block
+   scalar:    ~(op | whitespace | quote) outside strings, only the first byte
+              of each scalar is structural
+
+ The output is the offset of every operator outside strings, every opening
+ quote and the first byte of every scalar (true, 123, ...). A string which is
+ not closed, or a control character inside a string, is an error.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#   define SCAN_X86 1
+#   include <immintrin.h>
+#   if defined(__GNUC__) || defined(__clang__)
+#       define SCAN_TARGET(isa) __attribute__((target(isa)))
+#   else
+#       define SCAN_TARGET(isa)
+#       include <intrin.h>
+#   endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#   define SCAN_NEON 1
+#   include <arm_neon.h>
+#endif
+
+typedef struct {
+    u64 quote;
+    u64 backslash;
+    u64 op;         /* { } [ ] : , */
+    u64 space;      /* space, \t, \n, \r */
+    u64 ctrl;       /* < 0x20 */
+} scan_masks;
+
+typedef struct {
+    u64 prev_escaped;   /* the first byte of next block is escaped */
+    u64 prev_in_string; /* all 1 if the next block begins inside a string */
+    u64 prev_scalar;    /* the last byte of the block is a scalar byte */
+    u64 error;          /* control characters inside strings */
+} scan_state;
+
+static yy_inline u32 scan_ctz(u64 v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (u32)__builtin_ctzll(v);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long r;
+    _BitScanForward64(&r, v);
+    return (u32)r;
+#else
+    u32 r = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        r++;
+    }
+    return r;
+#endif
+}
+
+static yy_inline u64 scan_prefix_xor(u64 v) {
+    v ^= v << 1;
+    v ^= v << 2;
+    v ^= v << 4;
+    v ^= v << 8;
+    v ^= v << 16;
+    v ^= v << 32;
+    return v;
+}
+
+/* Returns the unescaped quotes of the block. */
+static yy_inline u64 scan_quotes(scan_state *s, const scan_masks *m) {
+    const u64 even_bits = 0x5555555555555555ULL;
+    u64 backslash = m->backslash & ~s->prev_escaped;
+    u64 follows_escape = (backslash << 1) | s->prev_escaped;
+    u64 odd_starts = backslash & ~even_bits & ~follows_escape;
+    u64 even_seqs = odd_starts + backslash;
+    /* a run which reaches the end of the block escapes the next block */
+    s->prev_escaped = even_seqs < odd_starts;
+    u64 escaped = (even_bits ^ (even_seqs << 1)) & follows_escape;
+    return m->quote & ~escaped;
+}
+
+/* Append the structural offsets of the block, `prefix` is the prefix xor of
+   `quote`, returns the new offset count. */
+static yy_inline usize scan_structurals(scan_state *s, const scan_masks *m, u64 quote,
+                                        u64 prefix, u32 base, u32 *idx, usize num) {
+    u64 in_string = prefix ^ s->prev_in_string;
+    s->prev_in_string = (u64)((i64)in_string >> 63);
+    s->error |= m->ctrl & in_string;
+
+    u64 scalar = ~(m->op | m->space | m->quote) & ~in_string;
+    u64 scalar_start = scalar & ~((scalar << 1) | s->prev_scalar);
+    s->prev_scalar = scalar >> 63;
+
+    u64 bits = (m->op & ~in_string) | scalar_start | (quote & in_string);
+    while (bits) {
+        idx[num++] = base + scan_ctz(bits);
+        bits &= bits - 1;
+    }
+    return num;
+}
+
+
+
+/*==============================================================================
+ * Classification
+ *============================================================================*/
+
+static void scan_classify_scalar(const u8 *src, scan_masks *m) {
+    memset(m, 0, sizeof(scan_masks));
+    for (int i = 0; i < 64; i++) {
+        u64 bit = (u64)1 << i;
+        switch (src[i]) {
+            case '"': m->quote |= bit; break;
+            case '\\': m->backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                m->op |= bit;
+                break;
+            case ' ':
+                m->space |= bit;
+                break;
+            case '\t': case '\n': case '\r':
+                m->space |= bit;
+                m->ctrl |= bit;
+                break;
+            default:
+                if (src[i] < 0x20) m->ctrl |= bit;
+                break;
+        }
+    }
+}
+
+#if SCAN_X86
+
+static yy_inline void scan_classify_sse2(const u8 *src, scan_masks *m) {
+    memset(m, 0, sizeof(scan_masks));
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)(src + i * 16));
+        /* '[' | 0x20 is '{' and ']' | 0x20 is '}' */
+        __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        __m128i op = _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')),
+                                  _mm_cmpeq_epi8(lower, _mm_set1_epi8('}')));
+        op = _mm_or_si128(op, _mm_cmpeq_epi8(v, _mm_set1_epi8(':')));
+        op = _mm_or_si128(op, _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+        __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+        space = _mm_or_si128(space, _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+        space = _mm_or_si128(space, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+        __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v);
+        int shift = i * 16;
+        m->quote |= (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << shift;
+        m->backslash |= (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << shift;
+        m->op |= (u64)(u32)_mm_movemask_epi8(op) << shift;
+        m->space |= (u64)(u32)_mm_movemask_epi8(space) << shift;
+        m->ctrl |= (u64)(u32)_mm_movemask_epi8(ctrl) << shift;
+    }
+}
+
+SCAN_TARGET("avx2")
+static yy_inline void scan_classify_avx2(const u8 *src, scan_masks *m) {
+    memset(m, 0, sizeof(scan_masks));
+    for (int i = 0; i < 2; i++) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(const void *)(src + i * 32));
+        __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        __m256i op = _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')),
+                                     _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}')));
+        op = _mm256_or_si256(op, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')));
+        op = _mm256_or_si256(op, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')));
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+        space = _mm256_or_si256(space, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+        space = _mm256_or_si256(space, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+        __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v);
+        int shift = i * 32;
+        m->quote |= (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))) << shift;
+        m->backslash |= (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))) << shift;
+        m->op |= (u64)(u32)_mm256_movemask_epi8(op) << shift;
+        m->space |= (u64)(u32)_mm256_movemask_epi8(space) << shift;
+        m->ctrl |= (u64)(u32)_mm256_movemask_epi8(ctrl) << shift;
+    }
+}
+
+SCAN_TARGET("avx512f,avx512bw")
+static yy_inline void scan_classify_avx512(const u8 *src, scan_masks *m) {
+    __m512i v = _mm512_loadu_si512((const void *)src);
+    __m512i lower = _mm512_or_si512(v, _mm512_set1_epi8(0x20));
+    m->quote = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('"'));
+    m->backslash = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\\'));
+    m->op = _mm512_cmpeq_epi8_mask(lower, _mm512_set1_epi8('{')) |
+            _mm512_cmpeq_epi8_mask(lower, _mm512_set1_epi8('}')) |
+            _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(':')) |
+            _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(','));
+    m->space = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(' ')) |
+               _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\t')) |
+               _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\n')) |
+               _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\r'));
+    m->ctrl = _mm512_cmplt_epu8_mask(v, _mm512_set1_epi8(0x20));
+}
+
+/* Prefix xor with carry-less multiplication by all ones. */
+SCAN_TARGET("pclmul")
+static yy_inline u64 scan_prefix_xor_clmul(u64 v) {
+    __m128i r = _mm_clmulepi64_si128(_mm_set_epi64x(0, (i64)v), _mm_set1_epi8((char)0xFF), 0);
+    return (u64)_mm_cvtsi128_si64(r);
+}
+
+#endif /* SCAN_X86 */
+
+#if SCAN_NEON
+
+/* Movemask of four 16-byte compare results (0x00 or 0xFF per byte). */
+static yy_inline u64 scan_neon_mask(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d) {
+    const uint8x16_t bits = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t sum0 = vpaddq_u8(vandq_u8(a, bits), vandq_u8(b, bits));
+    uint8x16_t sum1 = vpaddq_u8(vandq_u8(c, bits), vandq_u8(d, bits));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+static yy_inline void scan_classify_neon(const u8 *src, scan_masks *m) {
+    uint8x16_t quote[4], backslash[4], op[4], space[4], ctrl[4];
+    for (int i = 0; i < 4; i++) {
+        uint8x16_t v = vld1q_u8(src + i * 16);
+        uint8x16_t lower = vorrq_u8(v, vdupq_n_u8(0x20));
+        quote[i] = vceqq_u8(v, vdupq_n_u8('"'));
+        backslash[i] = vceqq_u8(v, vdupq_n_u8('\\'));
+        op[i] = vorrq_u8(vceqq_u8(lower, vdupq_n_u8('{')), vceqq_u8(lower, vdupq_n_u8('}')));
+        op[i] = vorrq_u8(op[i], vceqq_u8(v, vdupq_n_u8(':')));
+        op[i] = vorrq_u8(op[i], vceqq_u8(v, vdupq_n_u8(',')));
+        space[i] = vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8('\t')));
+        space[i] = vorrq_u8(space[i], vceqq_u8(v, vdupq_n_u8('\n')));
+        space[i] = vorrq_u8(space[i], vceqq_u8(v, vdupq_n_u8('\r')));
+        ctrl[i] = vcltq_u8(v, vdupq_n_u8(0x20));
+    }
+    m->quote = scan_neon_mask(quote[0], quote[1], quote[2], quote[3]);
+    m->backslash = scan_neon_mask(backslash[0], backslash[1], backslash[2], backslash[3]);
+    m->op = scan_neon_mask(op[0], op[1], op[2], op[3]);
+    m->space = scan_neon_mask(space[0], space[1], space[2], space[3]);
+    m->ctrl = scan_neon_mask(ctrl[0], ctrl[1], ctrl[2], ctrl[3]);
+}
+
+#endif /* SCAN_NEON */
+
+
+
+/*==============================================================================
+ * Scanner
+ *============================================================================*/
+
+/* Define the scanner of an instruction set, the last partial block is copied
+   to a buffer padded with spaces. */
+#define SCAN_DEFINE(name, classify, prefix_xor) \
+static usize scan_index_##name(const u8 *src, usize size, u32 *idx) { \
+    scan_state s; \
+    scan_masks m; \
+    u8 tail[64]; \
+    usize num = 0, pos = 0; \
+    memset(&s, 0, sizeof(s)); \
+    for (; pos + 64 <= size; pos += 64) { \
+        classify(src + pos, &m); \
+        u64 quote = scan_quotes(&s, &m); \
+        num = scan_structurals(&s, &m, quote, prefix_xor(quote), (u32)pos, idx, num); \
+    } \
+    if (pos < size) { \
+        memset(tail, ' ', 64); \
+        memcpy(tail, src + pos, size - pos); \
+        classify(tail, &m); \
+        u64 quote = scan_quotes(&s, &m); \
+        num = scan_structurals(&s, &m, quote, prefix_xor(quote), (u32)pos, idx, num); \
+    } \
+    if (s.prev_in_string || s.error) return SIZE_MAX; \
+    return num; \
+}
+
+SCAN_DEFINE(scalar, scan_classify_scalar, scan_prefix_xor)
+
+#if SCAN_X86
+SCAN_DEFINE(sse2, scan_classify_sse2, scan_prefix_xor)
+SCAN_TARGET("avx2,pclmul")
+SCAN_DEFINE(avx2, scan_classify_avx2, scan_prefix_xor_clmul)
+SCAN_TARGET("avx512f,avx512bw,pclmul")
+SCAN_DEFINE(avx512, scan_classify_avx512, scan_prefix_xor_clmul)
+#endif
+
+#if SCAN_NEON
+SCAN_DEFINE(neon, scan_classify_neon, scan_prefix_xor)
+#endif
+
+#undef SCAN_DEFINE
+
+
+static const char *scan_isa_names[JSON_SCAN_ISA_NUM] = {
+    "scalar", "sse2", "avx2", "avx512", "neon"
+};
+
+const char *json_scan_isa_name(json_scan_isa isa) {
+    return (unsigned)isa < JSON_SCAN_ISA_NUM ? scan_isa_names[isa] : "unknown";
+}
+
+#if SCAN_X86 && defined(_MSC_VER) && !defined(__clang__)
+/* Check the CPU features and the OS support of the register states. */
+static bool scan_cpu_supports(json_scan_isa isa) {
+    int info[4];
+    __cpuid(info, 1);
+    bool pclmul = (info[2] & (1 << 1)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || !pclmul) return false;
+    u64 xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    if (isa == JSON_SCAN_AVX2) {
+        return (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+    }
+    /* AVX-512 F and BW, with opmask and ZMM states */
+    return (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+}
+#elif SCAN_X86
+static bool scan_cpu_supports(json_scan_isa isa) {
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("pclmul")) return false;
+    if (isa == JSON_SCAN_AVX2) return __builtin_cpu_supports("avx2");
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+}
+#endif
+
+bool json_scan_supported(json_scan_isa isa) {
+    switch (isa) {
+        case JSON_SCAN_SCALAR:
+            return true;
+#if SCAN_X86
+        case JSON_SCAN_SSE2:
+            return true;
+        case JSON_SCAN_AVX2:
+        case JSON_SCAN_AVX512:
+            return scan_cpu_supports(isa);
+#endif
+#if SCAN_NEON
+        case JSON_SCAN_NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+json_scan_isa json_scan_best(void) {
+    static const json_scan_isa order[] = {
+        JSON_SCAN_AVX512, JSON_SCAN_AVX2, JSON_SCAN_NEON, JSON_SCAN_SSE2
+    };
+    for (usize i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        if (json_scan_supported(order[i])) return order[i];
+    }
+    return JSON_SCAN_SCALAR;
+}
+
+usize json_scan_index(json_scan_isa isa, const char *json, usize size, u32 *idx) {
+    const u8 *src = (const u8 *)json;
+    if (size > UINT32_MAX - 64) return SIZE_MAX;
+    switch (isa) {
+#if SCAN_X86
+        case JSON_SCAN_SSE2: return scan_index_sse2(src, size, idx);
+        case JSON_SCAN_AVX2: return scan_index_avx2(src, size, idx);
+        case JSON_SCAN_AVX512: return scan_index_avx512(src, size, idx);
+#endif
+#if SCAN_NEON
+        case JSON_SCAN_NEON: return scan_index_neon(src, size, idx);
+#endif
+        default: return scan_index_scalar(src, size, idx);
+    }
+}
@@ -0,0 +1,203 @@
+#include "benchmark.h"
+
+
+/*
+ Speculative split of a large JSON array.
+
+ The input is divided into equal-size chunks, and every chunk is scanned
+ concurrently without knowing whether it begins inside a string or at what
+ nesting depth. Since a chunk may only begin inside or outside a string, both
+ hypotheses are evaluated in the same pass: a quote flips the hypothesis that
+ currently sees "outside string", and only that hypothesis updates its depth.
+ For each hypothesis we record the net depth change and the first comma at
+ each relative depth, then a short serial pass resolves the real state of every
+ chunk and picks its first top-level comma as a split point.
+ */
+
+#define SPLIT_MAX_DEPTH 16
+
+typedef struct {
+    usize beg, end;                  /* chunk range in input */
+    usize parity;                    /* unescaped quote count & 1 */
+    i64 delta[2];                    /* depth change for each hypothesis */
+    usize comma[2][SPLIT_MAX_DEPTH]; /* first comma at relative depth -i */
+} split_chunk;
+
+typedef struct {
+    const char *json;
+    split_chunk *chunks;
+} split_ctx;
+
+static yy_inline bool split_is_escaped(const char *json, const char *cur) {
+    usize n = 0;
+    while (cur - n > json && *(cur - 1 - n) == '\\') n++;
+    return (n & 1) != 0;
+}
+
+static void split_scan_chunk(void *ctx_ptr, int idx) {
+    split_ctx *ctx = (split_ctx *)ctx_ptr;
+    split_chunk *chunk = ctx->chunks + idx;
+    const char *json = ctx->json;
+    const char *cur = json + chunk->beg;
+    const char *end = json + chunk->end;
+    usize q = 0; /* hypothesis which is outside string now */
+    i64 d[2] = { 0, 0 };
+
+    for (int h = 0; h < 2; h++) {
+        for (int i = 0; i < SPLIT_MAX_DEPTH; i++) chunk->comma[h][i] = SIZE_MAX;
+    }
+
+    for (; cur < end; cur++) {
+        switch (*cur) {
+            case '"':
+                if (!split_is_escaped(json, cur)) q ^= 1;
+                break;
+            case '[': case '{':
+                d[q]++;
+                break;
+            case ']': case '}':
+                d[q]--;
+                break;
+            case ',':
+                if (d[q] <= 0 && -d[q] < SPLIT_MAX_DEPTH &&
+                    chunk->comma[q][-d[q]] == SIZE_MAX) {
+                    chunk->comma[q][-d[q]] = (usize)(cur - json);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    /* hypothesis 0: chunk starts outside string, 1: starts inside string */
+    chunk->parity = q;
+    chunk->delta[0] = d[0];
+    chunk->delta[1] = d[1];
+}
+
+/* Slow path: find the first comma at `depth` with a known start state. */
+static usize split_find_comma(const char *json, usize beg, usize end,
+                              bool in_str, i64 depth) {
+    for (usize i = beg; i < end; i++) {
+        char c = json[i];
+        if (c == '"') {
+            if (!split_is_escaped(json, json + i)) in_str = !in_str;
+        } else if (in_str) {
+            continue;
+        } else if (c == '[' || c == '{') {
+            depth++;
+        } else if (c == ']' || c == '}') {
+            depth--;
+        } else if (c == ',' && depth == 1) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+int json_array_split(const char *json, usize size, usize *splits,
+                     int count, yy_thread_pool *pool) {
+    usize beg = 0, end = size;
+
+    /* locate the root brackets */
+    while (beg < end && (json[beg] == ' ' || json[beg] == '\t' ||
+                         json[beg] == '\n' || json[beg] == '\r')) beg++;
+    while (end > beg && (json[end - 1] == ' ' || json[end - 1] == '\t' ||
+                         json[end - 1] == '\n' || json[end - 1] == '\r' ||
+                         json[end - 1] == '\0')) end--;
+    if (end - beg < 2 || json[beg] != '[' || json[end - 1] != ']') return 0;
+    end--;
+    if (count < 1) count = 1;
+    if ((usize)count > end - beg) count = (int)(end - beg);
+
+    split_chunk *chunks = malloc((usize)count * sizeof(split_chunk));
+    if (!chunks) return 0;
+    usize chunk_size = (end - beg - 1) / (usize)count;
+    for (int i = 0; i < count; i++) {
+        chunks[i].beg = beg + 1 + chunk_size * (usize)i;
+        chunks[i].end = (i + 1 == count) ? end : chunks[i].beg + chunk_size;
+    }
+
+    split_ctx ctx;
+    ctx.json = json;
+    ctx.chunks = chunks;
+    yy_thread_pool_run(pool, split_scan_chunk, &ctx, count);
+
+    /* resolve the real state of each chunk */
+    int num = 0;
+    usize state = 0;
+    i64 depth = 1;
+    splits[num++] = beg;
+    for (int i = 0; i < count; i++) {
+        split_chunk *chunk = chunks + i;
+        if (i > 0) {
+            usize pos;
+            if (depth - 1 < SPLIT_MAX_DEPTH) {
+                pos = chunk->comma[state][depth - 1];
+            } else {
+                pos = split_find_comma(json, chunk->beg, chunk->end, state != 0, depth);
+            }
+            if (pos != SIZE_MAX) splits[num++] = pos;
+        }
+        depth += chunk->delta[state];
+        state ^= chunk->parity;
+        if (depth < 1) break;
+    }
+    free(chunks);
+
+    /* the document is not a well-formed array, let the parser report it */
+    if (state != 0 || depth != 1) return 0;
+    splits[num] = end;
+    return num;
+}
+
+
+
+/*
+ Join serialized segments of a container.
+ The output offset of each segment is computed serially, then the segments are
+ copied to the output concurrently.
+ */
+
+typedef struct {
+    const json_segment *segs;
+    usize *offs;
+    char *dst;
+} join_ctx;
+
+static void join_copy_segment(void *ctx_ptr, int idx) {
+    join_ctx *ctx = (join_ctx *)ctx_ptr;
+    const json_segment *seg = ctx->segs + idx;
+    char *cur = ctx->dst + ctx->offs[idx];
+    if (idx > 0) *cur++ = ',';
+    if (cur != seg->str) memcpy(cur, seg->str, seg->len);
+}
+
+usize json_segments_join_size(const json_segment *segs, int count) {
+    usize size = 3; /* brackets and null-terminator */
+    for (int i = 0; i < count; i++) size += segs[i].len + (i > 0);
+    return size;
+}
+
+usize json_segments_join(const json_segment *segs, int count, bool is_obj,
+                         char *dst, yy_thread_pool *pool) {
+    usize *offs = malloc(((usize)count + 1) * sizeof(usize));
+    if (!offs) return 0;
+    usize pos = 1;
+    for (int i = 0; i < count; i++) {
+        offs[i] = pos;
+        pos += segs[i].len + (i > 0);
+    }
+    
+    join_ctx ctx;
+    ctx.segs = segs;
+    ctx.offs = offs;
+    ctx.dst = dst;
+    yy_thread_pool_run(pool, join_copy_segment, &ctx, count);
+    free(offs);
+    
+    dst[0] = is_obj ? '{' : '[';
+    dst[pos] = is_obj ? '}' : ']';
+    dst[pos + 1] = '\0';
+    return pos + 1;
+}
@@ -0,0 +1,321 @@
+#include "benchmark.h"
+
+
+/*
+ Standalone UTF-8 validators, used as the baseline of the validation cost.
+
+ The scalar validator checks one code point at a time, with an 8-byte ASCII
+ fast path. The SIMD validator is the lookup algorithm of simdjson (Keiser and
+ Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"): three
+ 16-entry table lookups on the high and low nibbles of the previous byte and
+ the high nibble of the current byte classify the error of each byte pair,
+ and the continuation bytes of 3 and 4 byte sequences are checked with the
+ bytes 2 and 3 positions back. A block of ASCII only checks that no sequence
+ was left incomplete by the previous block.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#   define UTF8_SSSE3 1
+#   include <immintrin.h>
+#   if defined(__GNUC__) || defined(__clang__)
+#       define UTF8_TARGET __attribute__((target("ssse3")))
+#   else
+#       define UTF8_TARGET
+#       include <intrin.h>
+#   endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#   define UTF8_NEON 1
+#   include <arm_neon.h>
+#endif
+
+
+
+/*==============================================================================
+ * Scalar
+ *============================================================================*/
+
+static bool utf8_validate_scalar(const u8 *cur, const u8 *end) {
+    while (cur < end) {
+        if (end - cur >= 8) {
+            u64 v;
+            memcpy(&v, cur, 8);
+            if (!(v & 0x8080808080808080ULL)) {
+                cur += 8;
+                continue;
+            }
+        }
+        u8 c = *cur;
+        if (c < 0x80) {
+            cur++;
+        } else if (c >= 0xC2 && c <= 0xDF) {
+            if (end - cur < 2 || (cur[1] & 0xC0) != 0x80) return false;
+            cur += 2;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            if (end - cur < 3 || (cur[1] & 0xC0) != 0x80 || (cur[2] & 0xC0) != 0x80) return false;
+            if (c == 0xE0 && cur[1] < 0xA0) return false; /* overlong */
+            if (c == 0xED && cur[1] > 0x9F) return false; /* surrogate */
+            cur += 3;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            if (end - cur < 4 || (cur[1] & 0xC0) != 0x80 ||
+                (cur[2] & 0xC0) != 0x80 || (cur[3] & 0xC0) != 0x80) return false;
+            if (c == 0xF0 && cur[1] < 0x90) return false; /* overlong */
+            if (c == 0xF4 && cur[1] > 0x8F) return false; /* > U+10FFFF */
+            cur += 4;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/*==============================================================================
+ * SIMD lookup tables
+ *============================================================================*/
+
+#define UTF8_TOO_SHORT      (1 << 0) /* lead byte not followed by continuation */
+#define UTF8_TOO_LONG       (1 << 1) /* ASCII followed by continuation */
+#define UTF8_OVERLONG_3     (1 << 2)
+#define UTF8_TOO_LARGE      (1 << 3)
+#define UTF8_SURROGATE      (1 << 4)
+#define UTF8_OVERLONG_2     (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4     (1 << 6)
+#define UTF8_TWO_CONTS      (1 << 7) /* two continuations, or must be 3rd/4th byte */
+#define UTF8_CARRY          (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+#if UTF8_SSSE3 || UTF8_NEON
+
+/* Indexed by the high nibble of the previous byte. */
+static const u8 utf8_byte_1_high[16] = {
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+};
+
+/* Indexed by the low nibble of the previous byte. */
+static const u8 utf8_byte_1_low[16] = {
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+};
+
+/* Indexed by the high nibble of the current byte. */
+static const u8 utf8_byte_2_high[16] = {
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |
+        UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+};
+
+/* The last 3 bytes of a block may not begin a 4, 3 or 2 byte sequence. */
+static const u8 utf8_incomplete_max[16] = {
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+
+#endif
+
+
+
+/*==============================================================================
+ * SSSE3
+ *============================================================================*/
+
+#if UTF8_SSSE3
+
+UTF8_TARGET
+static yy_inline __m128i utf8_check_block_ssse3(__m128i input, __m128i prev_input) {
+    const __m128i lo_mask = _mm_set1_epi8(0x0F);
+    const __m128i t_1_high = _mm_loadu_si128((const __m128i *)(const void *)utf8_byte_1_high);
+    const __m128i t_1_low = _mm_loadu_si128((const __m128i *)(const void *)utf8_byte_1_low);
+    const __m128i t_2_high = _mm_loadu_si128((const __m128i *)(const void *)utf8_byte_2_high);
+
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 16 - 1);
+    __m128i b1h = _mm_shuffle_epi8(t_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), lo_mask));
+    __m128i b1l = _mm_shuffle_epi8(t_1_low, _mm_and_si128(prev1, lo_mask));
+    __m128i b2h = _mm_shuffle_epi8(t_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), lo_mask));
+    __m128i special = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+
+    /* 3rd and 4th bytes of a sequence must be continuations */
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 16 - 2);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 16 - 3);
+    __m128i is_third = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+    __m128i is_fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+    __m128i must23 = _mm_and_si128(_mm_or_si128(is_third, is_fourth), _mm_set1_epi8((char)0x80));
+    return _mm_xor_si128(must23, special);
+}
+
+UTF8_TARGET
+static bool utf8_validate_ssse3(const u8 *cur, const u8 *end) {
+    const __m128i incomplete_max = _mm_loadu_si128((const __m128i *)(const void *)utf8_incomplete_max);
+    __m128i error = _mm_setzero_si128();
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    u8 tail[16];
+
+    while (cur < end) {
+        __m128i input;
+        if (end - cur >= 16) {
+            input = _mm_loadu_si128((const __m128i *)(const void *)cur);
+        } else {
+            /* the last partial block is padded with ASCII */
+            memset(tail, 0, 16);
+            memcpy(tail, cur, (usize)(end - cur));
+            input = _mm_loadu_si128((const __m128i *)(const void *)tail);
+        }
+        cur += 16;
+        if (_mm_movemask_epi8(input) == 0) {
+            error = _mm_or_si128(error, prev_incomplete);
+        } else {
+            error = _mm_or_si128(error, utf8_check_block_ssse3(input, prev_input));
+            prev_incomplete = _mm_subs_epu8(input, incomplete_max);
+        }
+        prev_input = input;
+    }
+    error = _mm_or_si128(error, prev_incomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+static bool utf8_cpu_supports_ssse3(void) {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+}
+#else
+static bool utf8_cpu_supports_ssse3(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+}
+#endif
+
+#endif /* UTF8_SSSE3 */
+
+
+
+/*==============================================================================
+ * NEON
+ *============================================================================*/
+
+#if UTF8_NEON
+
+static yy_inline uint8x16_t utf8_check_block_neon(uint8x16_t input, uint8x16_t prev_input) {
+    const uint8x16_t lo_mask = vdupq_n_u8(0x0F);
+    const uint8x16_t t_1_high = vld1q_u8(utf8_byte_1_high);
+    const uint8x16_t t_1_low = vld1q_u8(utf8_byte_1_low);
+    const uint8x16_t t_2_high = vld1q_u8(utf8_byte_2_high);
+
+    uint8x16_t prev1 = vextq_u8(prev_input, input, 16 - 1);
+    uint8x16_t b1h = vqtbl1q_u8(t_1_high, vshrq_n_u8(prev1, 4));
+    uint8x16_t b1l = vqtbl1q_u8(t_1_low, vandq_u8(prev1, lo_mask));
+    uint8x16_t b2h = vqtbl1q_u8(t_2_high, vshrq_n_u8(input, 4));
+    uint8x16_t special = vandq_u8(vandq_u8(b1h, b1l), b2h);
+
+    uint8x16_t prev2 = vextq_u8(prev_input, input, 16 - 2);
+    uint8x16_t prev3 = vextq_u8(prev_input, input, 16 - 3);
+    uint8x16_t is_third = vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80));
+    uint8x16_t is_fourth = vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80));
+    uint8x16_t must23 = vandq_u8(vorrq_u8(is_third, is_fourth), vdupq_n_u8(0x80));
+    return veorq_u8(must23, special);
+}
+
+static bool utf8_validate_neon(const u8 *cur, const u8 *end) {
+    const uint8x16_t incomplete_max = vld1q_u8(utf8_incomplete_max);
+    uint8x16_t error = vdupq_n_u8(0);
+    uint8x16_t prev_input = vdupq_n_u8(0);
+    uint8x16_t prev_incomplete = vdupq_n_u8(0);
+    u8 tail[16];
+
+    while (cur < end) {
+        uint8x16_t input;
+        if (end - cur >= 16) {
+            input = vld1q_u8(cur);
+        } else {
+            memset(tail, 0, 16);
+            memcpy(tail, cur, (usize)(end - cur));
+            input = vld1q_u8(tail);
+        }
+        cur += 16;
+        if (vmaxvq_u8(input) < 0x80) {
+            error = vorrq_u8(error, prev_incomplete);
+        } else {
+            error = vorrq_u8(error, utf8_check_block_neon(input, prev_input));
+            prev_incomplete = vqsubq_u8(input, incomplete_max);
+        }
+        prev_input = input;
+    }
+    error = vorrq_u8(error, prev_incomplete);
+    return vmaxvq_u8(error) == 0;
+}
+
+#endif /* UTF8_NEON */
+
+
+
+/*==============================================================================
+ * Dispatch
+ *============================================================================*/
+
+bool json_utf8_supported(json_utf8_impl impl) {
+    switch (impl) {
+        case JSON_UTF8_SCALAR:
+            return true;
+        case JSON_UTF8_SIMD:
+#if UTF8_SSSE3
+            return utf8_cpu_supports_ssse3();
+#elif UTF8_NEON
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+const char *json_utf8_impl_name(json_utf8_impl impl) {
+    switch (impl) {
+        case JSON_UTF8_SCALAR: return "scalar";
+#if UTF8_SSSE3
+        case JSON_UTF8_SIMD: return "ssse3";
+#elif UTF8_NEON
+        case JSON_UTF8_SIMD: return "neon";
+#endif
+        default: return "unknown";
+    }
+}
+
+bool json_utf8_validate(json_utf8_impl impl, const char *str, usize len) {
+    const u8 *cur = (const u8 *)str;
+    switch (impl) {
+#if UTF8_SSSE3
+        case JSON_UTF8_SIMD: return utf8_validate_ssse3(cur, cur + len);
+#elif UTF8_NEON
+        case JSON_UTF8_SIMD: return utf8_validate_neon(cur, cur + len);
+#endif
+        default: return utf8_validate_scalar(cur, cur + len);
+    }
+}
@@ -1335,7 +1335,7 @@ static bool yy_chart_axis_options_copy(yy_chart_axis_options *dst,
         int i, count;
         count = yy_chart_axis_category_count(src);
         if (count) {
-            dst->categories = calloc(count, sizeof(char *));
+            dst->categories = calloc(count + 1, sizeof(char *));
             if (!dst->categories) RETURN_FAIL();
             for (i = 0 ; i < count; i++) STR_COPY(categories[i]);
         }
@@ -1553,11 +1553,28 @@ bool yy_chart_sort_items_with_name(yy_chart *chart, bool ascent) {
 
 
 
+typedef struct {
+    char *title;
+    char **cells; /* row-major, the first row is the header */
+    usize row_count;
+    usize col_count;
+} yy_report_table;
+
 struct yy_report {
     ARR_TYPE(yy_chart *) charts;
     ARR_TYPE(char *) infos;
+    ARR_TYPE(yy_report_table) tables;
 };
 
+static void yy_report_table_release(yy_report_table *table) {
+    usize i;
+    if (table->cells) {
+        for (i = 0; i < table->row_count * table->col_count; i++) free(table->cells[i]);
+        free(table->cells);
+    }
+    free(table->title);
+}
+
 yy_report *yy_report_new(void) {
     yy_report *report = calloc(1, sizeof(yy_report));
     return report;
@@ -1576,6 +1593,11 @@ void yy_report_free(yy_report *report) {
     for (i = 0; i < count; i++) {
         free(*ARR_GET(report->infos, char *, i));
     }
+    
+    count = ARR_COUNT(report->tables, yy_report_table);
+    for (i = 0; i < count; i++) {
+        yy_report_table_release(ARR_GET(report->tables, yy_report_table, i));
+    }
 }
 
 bool yy_report_add_chart(yy_report *report, yy_chart *chart) {
@@ -1599,6 +1621,29 @@ bool yy_report_add_info(yy_report *report, const char *info) {
     }
 }
 
+bool yy_report_add_table(yy_report *report, const char *title, const char **cells,
+                         usize row_count, usize col_count) {
+    yy_report_table table;
+    usize i, count = row_count * col_count;
+    
+    if (!report || !cells || !count) return false;
+    memset(&table, 0, sizeof(table));
+    table.row_count = row_count;
+    table.col_count = col_count;
+    table.title = yy_str_copy(title ? title : "");
+    table.cells = calloc(count, sizeof(char *));
+    if (!table.title || !table.cells) goto fail;
+    for (i = 0; i < count; i++) {
+        table.cells[i] = yy_str_copy(cells[i] ? cells[i] : "");
+        if (!table.cells[i]) goto fail;
+    }
+    if (ARR_ADD(report->tables, table, yy_report_table)) return true;
+    
+fail:
+    yy_report_table_release(&table);
+    return false;
+}
+
 bool yy_report_add_env_info(yy_report *report) {
     char info[1024];
     snprintf(info, sizeof(info), "Compiler: %s", yy_env_get_compiler_desc());
@@ -1647,6 +1692,7 @@ bool yy_report_write_html_string(yy_report *report, char **html, usize *len) {
     
     usize chart_count = ARR_COUNT(report->charts, yy_chart *);
     usize info_count = ARR_COUNT(report->infos, char *);
+    usize table_count = ARR_COUNT(report->tables, yy_report_table);
     
     if (len) *len = 0;
     if (!report || !html) return false;
@@ -1701,6 +1747,19 @@ bool yy_report_write_html_string(yy_report *report, char **html, usize *len) {
     }
     LS("                </div>");
     LS("            </div>");
+    if (table_count) {
+        LS("            <div class='navbar-item has-dropdown is-hoverable'>");
+        LS("                <a class='navbar-link'>Tables</a>");
+        LS("                <div class='navbar-dropdown'>");
+        for (c = 0; c < table_count; c++) {
+            yy_report_table *table = ARR_GET(report->tables, yy_report_table, c);
+            AF("                    <a class='navbar-item' href='#table_%d'>", (int)c);
+            AH(table->title);
+            LS("</a>");
+        }
+        LS("                </div>");
+        LS("            </div>");
+    }
     LS("        </div>");
     LS("    </div>");
     LS("</nav>");
@@ -1929,6 +1988,33 @@ bool yy_report_write_html_string(yy_report *report, char **html, usize *len) {
         LS("</script>");
     }
     
+    for (c = 0; c < table_count; c++) {
+        yy_report_table *table = ARR_GET(report->tables, yy_report_table, c);
+        
+        LS("");
+        LF("<a name='table_%d'></a>", (int)c);
+        LS("<div style='width: 60px; height: 60px; margin: 0 auto'></div>");
+        LS("<div class='container'>");
+        AS("<h2 class='title is-5 has-text-centered'>"); AH(table->title); LS("</h2>");
+        LS("<div class='table-container'>");
+        LS("<table class='table is-narrow is-striped is-hoverable is-fullwidth'>");
+        for (i = 0; i < table->row_count; i++) {
+            const char *tag = i == 0 ? "th" : "td";
+            if (i == 0) LS("<thead>");
+            if (i == 1) LS("<tbody>");
+            AS("<tr>");
+            for (v = 0; v < table->col_count; v++) {
+                AF("<%s>", tag); AH(table->cells[i * table->col_count + v]); AF("</%s>", tag);
+            }
+            LS("</tr>");
+            if (i == 0) LS("</thead>");
+        }
+        if (table->row_count > 1) LS("</tbody>");
+        LS("</table>");
+        LS("</div>");
+        LS("</div>");
+    }
+    
     LS("");
     LS("</body>");
     AS("</html>");
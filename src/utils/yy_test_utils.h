@@ -795,6 +795,11 @@ bool yy_report_add_chart(yy_report *report, yy_chart *chart);
 /** Add a text information to report. */
 bool yy_report_add_info(yy_report *report, const char *info);
 
+/** Add a table to report, the cells are row-major and the first row is the header.
+    The strings are copied. */
+bool yy_report_add_table(yy_report *report, const char *title, const char **cells,
+                         usize row_count, usize col_count);
+
 /** Add environment information to report. */
 bool yy_report_add_env_info(yy_report *report);
 
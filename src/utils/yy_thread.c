@@ -0,0 +1,194 @@
+/*==============================================================================
+ * A minimal thread pool for multi-threaded benchmark.
+ *============================================================================*/
+
+#include "yy_thread.h"
+
+#ifndef _WIN32
+#   include <unistd.h>
+#endif
+
+
+
+/*==============================================================================
+ * Platform Wrapper
+ *============================================================================*/
+
+#ifdef _WIN32
+typedef HANDLE yy_thread_t;
+typedef CRITICAL_SECTION yy_mutex_t;
+typedef CONDITION_VARIABLE yy_cond_t;
+#define yy_mutex_init(m) InitializeCriticalSection(m)
+#define yy_mutex_destroy(m) DeleteCriticalSection(m)
+#define yy_mutex_lock(m) EnterCriticalSection(m)
+#define yy_mutex_unlock(m) LeaveCriticalSection(m)
+#define yy_cond_init(c) InitializeConditionVariable(c)
+#define yy_cond_destroy(c) ((void)0)
+#define yy_cond_wait(c, m) SleepConditionVariableCS(c, m, INFINITE)
+#define yy_cond_broadcast(c) WakeAllConditionVariable(c)
+#else
+typedef pthread_t yy_thread_t;
+typedef pthread_mutex_t yy_mutex_t;
+typedef pthread_cond_t yy_cond_t;
+#define yy_mutex_init(m) pthread_mutex_init(m, NULL)
+#define yy_mutex_destroy(m) pthread_mutex_destroy(m)
+#define yy_mutex_lock(m) pthread_mutex_lock(m)
+#define yy_mutex_unlock(m) pthread_mutex_unlock(m)
+#define yy_cond_init(c) pthread_cond_init(c, NULL)
+#define yy_cond_destroy(c) pthread_cond_destroy(c)
+#define yy_cond_wait(c, m) pthread_cond_wait(c, m)
+#define yy_cond_broadcast(c) pthread_cond_broadcast(c)
+#endif
+
+
+
+/*==============================================================================
+ * Thread Pool
+ *============================================================================*/
+
+struct yy_thread_pool {
+    int thread_count;
+    yy_thread_t *threads; /* thread_count - 1 workers */
+
+    yy_mutex_t lock;
+    yy_cond_t work_cond; /* signaled when a new batch is posted or on stop */
+    yy_cond_t done_cond; /* signaled when a batch is finished */
+
+    /* current batch, protected by lock */
+    yy_thread_task_func func;
+    void *ctx;
+    int task_count;
+    int task_next;
+    int task_done;
+    u64 batch_id;
+    bool stop;
+};
+
+/** Takes and runs tasks of current batch until no task left.
+    The lock should be held before calling, and is held on return. */
+static void yy_thread_pool_drain(yy_thread_pool *pool) {
+    while (pool->task_next < pool->task_count) {
+        int idx = pool->task_next++;
+        yy_thread_task_func func = pool->func;
+        void *ctx = pool->ctx;
+        yy_mutex_unlock(&pool->lock);
+        func(ctx, idx);
+        yy_mutex_lock(&pool->lock);
+        if (++pool->task_done == pool->task_count) {
+            yy_cond_broadcast(&pool->done_cond);
+        }
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI yy_thread_pool_worker(LPVOID arg) {
+#else
+static void *yy_thread_pool_worker(void *arg) {
+#endif
+    yy_thread_pool *pool = (yy_thread_pool *)arg;
+    u64 batch_id = 0;
+
+    yy_mutex_lock(&pool->lock);
+    while (true) {
+        while (!pool->stop && pool->batch_id == batch_id) {
+            yy_cond_wait(&pool->work_cond, &pool->lock);
+        }
+        if (pool->stop) break;
+        batch_id = pool->batch_id;
+        yy_thread_pool_drain(pool);
+    }
+    yy_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+yy_thread_pool *yy_thread_pool_new(int thread_count) {
+    if (thread_count < 1) thread_count = 1;
+    yy_thread_pool *pool = calloc(1, sizeof(yy_thread_pool));
+    if (!pool) return NULL;
+    pool->threads = calloc((usize)thread_count, sizeof(yy_thread_t));
+    if (!pool->threads) {
+        free(pool);
+        return NULL;
+    }
+    yy_mutex_init(&pool->lock);
+    yy_cond_init(&pool->work_cond);
+    yy_cond_init(&pool->done_cond);
+
+    pool->thread_count = 1;
+    for (int i = 0; i < thread_count - 1; i++) {
+#ifdef _WIN32
+        pool->threads[i] = CreateThread(NULL, 0, yy_thread_pool_worker, pool, 0, NULL);
+        if (!pool->threads[i]) break;
+#else
+        if (pthread_create(&pool->threads[i], NULL, yy_thread_pool_worker, pool) != 0) break;
+#endif
+        pool->thread_count++;
+    }
+    if (pool->thread_count != thread_count) {
+        yy_thread_pool_free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void yy_thread_pool_free(yy_thread_pool *pool) {
+    if (!pool) return;
+    yy_mutex_lock(&pool->lock);
+    pool->stop = true;
+    yy_cond_broadcast(&pool->work_cond);
+    yy_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->thread_count - 1; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(pool->threads[i], INFINITE);
+        CloseHandle(pool->threads[i]);
+#else
+        pthread_join(pool->threads[i], NULL);
+#endif
+    }
+    yy_cond_destroy(&pool->work_cond);
+    yy_cond_destroy(&pool->done_cond);
+    yy_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool);
+}
+
+int yy_thread_pool_get_thread_count(yy_thread_pool *pool) {
+    return pool ? pool->thread_count : 0;
+}
+
+void yy_thread_pool_run(yy_thread_pool *pool, yy_thread_task_func func,
+                        void *ctx, int task_count) {
+    if (!pool || !func || task_count <= 0) return;
+    if (pool->thread_count == 1) {
+        for (int i = 0; i < task_count; i++) func(ctx, i);
+        return;
+    }
+
+    yy_mutex_lock(&pool->lock);
+    pool->func = func;
+    pool->ctx = ctx;
+    pool->task_count = task_count;
+    pool->task_next = 0;
+    pool->task_done = 0;
+    pool->batch_id++;
+    yy_cond_broadcast(&pool->work_cond);
+
+    // the calling thread works too
+    yy_thread_pool_drain(pool);
+    while (pool->task_done < pool->task_count) {
+        yy_cond_wait(&pool->done_cond, &pool->lock);
+    }
+    yy_mutex_unlock(&pool->lock);
+}
+
+int yy_thread_get_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
@@ -0,0 +1,64 @@
+/*==============================================================================
+ * A minimal thread pool for multi-threaded benchmark.
+ *============================================================================*/
+
+#ifndef yy_thread_h
+#define yy_thread_h
+
+#include "yy_test_utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/*==============================================================================
+ * Thread Pool
+ *============================================================================*/
+
+/*
+ Code Example:
+
+    static void task(void *ctx, int idx) {
+        int *arr = ctx;
+        arr[idx] = idx * idx;
+    }
+
+    int arr[100];
+    yy_thread_pool *pool = yy_thread_pool_new(4);
+    yy_thread_pool_run(pool, task, arr, 100); // blocks until all tasks done
+    yy_thread_pool_free(pool);
+ */
+
+/** A task function, `idx` is the task index in range [0, task_count). */
+typedef void (*yy_thread_task_func)(void *ctx, int idx);
+
+/** A thread pool object. */
+typedef struct yy_thread_pool yy_thread_pool;
+
+/** Creates a thread pool, the calling thread is counted as one of the threads.
+    Returns NULL on error. */
+yy_thread_pool *yy_thread_pool_new(int thread_count);
+
+/** Stops all threads and releases the thread pool. */
+void yy_thread_pool_free(yy_thread_pool *pool);
+
+/** Returns the thread count of the pool (include the calling thread). */
+int yy_thread_pool_get_thread_count(yy_thread_pool *pool);
+
+/** Runs `task_count` tasks on the pool and waits until all tasks are finished.
+    Tasks are taken in index order, but may run in any order. */
+void yy_thread_pool_run(yy_thread_pool *pool, yy_thread_task_func func,
+                        void *ctx, int task_count);
+
+/** Returns the number of logical processors. */
+int yy_thread_get_cpu_count(void);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -7,13 +7,14 @@ using namespace Windows::Foundation;
 
 extern "C"
 {
-    u64 reader_measure_winrt_json(const char* json, size_t size, int repeat);
+    u64 reader_measure_winrt_json(const char* json, size_t size, bool* valid, int repeat);
     u64 writer_measure_winrt_json(const char* json, size_t size, size_t* out_size,
         bool* roundtrip, bool pretty, int repeat);
     u64 stats_measure_winrt_json(const char* json, size_t size, stats_data* data, int repeat);
 }
-u64 reader_measure_winrt_json(const char* json, size_t size, int repeat)
+u64 reader_measure_winrt_json(const char* json, size_t size, bool* valid, int repeat)
 {
+    *valid = false;
     benchmark_tick_init();
     winrt::hstring jsonW = winrt::to_hstring(json);
 
@@ -24,6 +25,7 @@ u64 reader_measure_winrt_json(const char* json, size_t size, int repeat)
             auto parsed = winrt::Windows::Data::Json::JsonObject::Parse(jsonW);
             benchmark_tick_end();
         }
+        *valid = true;
         return benchmark_tick_min();
     }
     catch (...)
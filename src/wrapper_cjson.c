@@ -4,7 +4,8 @@
 // -----------------------------------------------------------------------------
 // reader
 
-u64 reader_measure_cjson(const char *json, size_t size, int repeat) {
+u64 reader_measure_cjson(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
     benchmark_tick_init();
     
     for (int i = 0; i < repeat; i++) {
@@ -15,6 +16,7 @@ u64 reader_measure_cjson(const char *json, size_t size, int repeat) {
         cJSON_Delete(doc);
     }
     
+    *valid = true;
     return benchmark_tick_min();
 }
 
@@ -115,3 +117,794 @@ u64 stats_measure_cjson(const char *json, size_t size, stats_data *data, int rep
     
     return benchmark_tick_min();
 }
+
+
+// -----------------------------------------------------------------------------
+// number reader
+
+u64 number_reader_measure_cjson(const number_data *data, f64 *vals,
+                                bool single, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        if (single) {
+            benchmark_tick_begin();
+            for (usize n = 0; n < data->count; n++) {
+                cJSON *doc = cJSON_ParseWithLength(data->strs[n], data->lens[n]);
+                vals[n] = cJSON_IsNumber(doc) ? doc->valuedouble : NAN;
+                cJSON_Delete(doc);
+            }
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            cJSON *doc = cJSON_ParseWithLength(data->array, data->array_size);
+            cJSON *val;
+            usize idx = 0;
+            cJSON_ArrayForEach(val, doc) {
+                vals[idx++] = val->valuedouble;
+            }
+            benchmark_tick_end();
+            if (!doc) return 0;
+            cJSON_Delete(doc);
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// number writer
+
+u64 number_writer_measure_cjson(const number_values *vals, char **out,
+                                usize *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    // cJSON stores all numbers as double, integers beyond 2^53 are not exact
+    cJSON *doc = cJSON_CreateArray();
+    for (usize n = 0; n < vals->count; n++) {
+        f64 num = vals->is_int ? (f64)vals->ints[n] : vals->reals[n];
+        cJSON_AddItemToArray(doc, cJSON_CreateNumber(num));
+    }
+    
+    char *str = NULL;
+    for (int i = 0; i < repeat; i++) {
+        free(str);
+        benchmark_tick_begin();
+        str = cJSON_PrintUnformatted(doc);
+        benchmark_tick_end();
+        if (!str) break;
+    }
+    cJSON_Delete(doc);
+    
+    *out = str;
+    *out_size = str ? strlen(str) : 0;
+    return str ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// roundtrip
+
+u64 roundtrip_measure_cjson(const char *json, size_t size, size_t *out_size,
+                            bool *roundtrip, int repeat) {
+    benchmark_tick_init();
+    
+    *roundtrip = true;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        cJSON *doc = cJSON_ParseWithLength(json, size);
+        char *str = doc ? cJSON_PrintUnformatted(doc) : NULL;
+        cJSON_Delete(doc);
+        benchmark_tick_end();
+        if (!str) return 0;
+        *out_size = strlen(str);
+        if (*out_size != size || memcmp(json, str, size) != 0) *roundtrip = false;
+        free(str);
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// lookup
+
+static cJSON *lookup_resolve(cJSON *val, const lookup_target *target) {
+    for (usize d = 0; d < target->depth && val; d++) {
+        if (cJSON_IsArray(val)) {
+            val = cJSON_GetArrayItem(val, (int)strtol(target->path[d], NULL, 10));
+        } else {
+            val = cJSON_GetObjectItemCaseSensitive(val, target->path[d]);
+        }
+    }
+    return val;
+}
+
+u64 lookup_measure_cjson(const char *json, size_t size,
+                         const lookup_target *targets, usize target_count,
+                         usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    cJSON *doc = cJSON_ParseWithLength(json, size);
+    if (!doc) return 0;
+    cJSON **objs = malloc((target_count + 1) * sizeof(cJSON *));
+    bool suc = true;
+    for (usize t = 0; t < target_count; t++) {
+        objs[t] = lookup_resolve(doc, targets + t);
+        if (!cJSON_IsObject(objs[t])) suc = false;
+    }
+    
+    // linear scan with strcmp
+    for (int i = 0; i < repeat && suc; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize t = 0; t < target_count; t++) {
+            const lookup_target *target = targets + t;
+            for (usize k = 0; k < target->key_count; k++) {
+                num += cJSON_GetObjectItemCaseSensitive(objs[t], target->keys[k]) != NULL;
+            }
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    free(objs);
+    cJSON_Delete(doc);
+    return suc ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// pointer (shared pointer parser, cJSON_Utils is not built)
+
+#define POINTER_MAX_TOKENS 64
+
+static yy_inline cJSON *pointer_walk(cJSON *val, const json_ptr_token *tokens, usize count) {
+    for (usize t = 0; t < count && val; t++) {
+        usize idx;
+        if (cJSON_IsObject(val)) {
+            val = cJSON_GetObjectItemCaseSensitive(val, tokens[t].str);
+        } else if (cJSON_IsArray(val) && json_pointer_token_to_index(tokens + t, &idx)) {
+            val = cJSON_GetArrayItem(val, (int)idx);
+        } else {
+            val = NULL;
+        }
+    }
+    return val;
+}
+
+u64 pointer_measure_cjson(const char *json, size_t size, const pointer_data *data,
+                          bool walk_only, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    cJSON *doc = cJSON_ParseWithLength(json, size);
+    if (!doc) return 0;
+    usize buf_len = 0;
+    for (usize p = 0; p < data->count; p++) {
+        if (data->lens[p] > buf_len) buf_len = data->lens[p];
+    }
+    char *buf = malloc(buf_len + 1);
+    json_ptr_token tokens[POINTER_MAX_TOKENS];
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        if (walk_only) {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                num += pointer_walk(doc, data->tokens[p], data->token_counts[p]) != NULL;
+            }
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                usize count = json_pointer_parse(data->ptrs[p], data->lens[p], buf,
+                                                 tokens, POINTER_MAX_TOKENS);
+                if (count == SIZE_MAX) continue;
+                num += pointer_walk(doc, tokens, count) != NULL;
+            }
+            benchmark_tick_end();
+        }
+        *found = num;
+    }
+    
+    free(buf);
+    cJSON_Delete(doc);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// path
+
+static json_path_type path_get_type(json_path_val val) {
+    const cJSON *v = (const cJSON *)val.ptr;
+    switch (v->type & 0xFF) {
+        case cJSON_NULL: return JSON_PATH_NULL;
+        case cJSON_False:
+        case cJSON_True: return JSON_PATH_BOOL;
+        case cJSON_Number: return JSON_PATH_NUM;
+        case cJSON_String: return JSON_PATH_STR;
+        case cJSON_Array: return JSON_PATH_ARR;
+        case cJSON_Object: return JSON_PATH_OBJ;
+        default: return JSON_PATH_NONE;
+    }
+}
+
+static bool path_get_bool(json_path_val val) {
+    return cJSON_IsTrue((const cJSON *)val.ptr);
+}
+
+static f64 path_get_num(json_path_val val) {
+    return ((const cJSON *)val.ptr)->valuedouble;
+}
+
+static const char *path_get_str(json_path_val val, usize *len) {
+    const char *str = ((const cJSON *)val.ptr)->valuestring;
+    *len = strlen(str);
+    return str;
+}
+
+static usize path_arr_size(json_path_val val) {
+    return (usize)cJSON_GetArraySize((const cJSON *)val.ptr);
+}
+
+static bool path_arr_get(json_path_val val, usize idx, json_path_val *out) {
+    out->ptr = cJSON_GetArrayItem((const cJSON *)val.ptr, (int)idx);
+    return out->ptr != NULL;
+}
+
+static bool path_obj_get(json_path_val val, const char *key, usize key_len,
+                         json_path_val *out) {
+    out->ptr = cJSON_GetObjectItemCaseSensitive((const cJSON *)val.ptr, key);
+    return out->ptr != NULL;
+}
+
+static void path_foreach(json_path_val val, json_path_each_func func, void *ctx) {
+    const cJSON *ctn = (const cJSON *)val.ptr, *v;
+    json_path_val sub = { NULL, 0 };
+    bool is_obj = cJSON_IsObject(ctn);
+    cJSON_ArrayForEach(v, ctn) {
+        sub.ptr = v;
+        if (is_obj) func(ctx, v->string, strlen(v->string), sub);
+        else func(ctx, NULL, 0, sub);
+    }
+}
+
+static const json_path_adapter path_adapter = {
+    path_get_type, path_get_bool, path_get_num, path_get_str,
+    path_arr_size, path_arr_get, path_obj_get, path_foreach
+};
+
+u64 path_measure_cjson(const char *json, size_t size, const json_path *path,
+                       bool with_parse, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    cJSON *doc = cJSON_ParseWithLength(json, size);
+    if (!doc) return 0;
+    json_path_val root = { NULL, 0 };
+    
+    for (int i = 0; i < repeat; i++) {
+        if (with_parse) {
+            benchmark_tick_begin();
+            cJSON *tmp = cJSON_ParseWithLength(json, size);
+            root.ptr = tmp;
+            if (tmp) *found = json_path_eval(path, &path_adapter, root);
+            cJSON_Delete(tmp);
+            benchmark_tick_end();
+            if (!tmp) {
+                cJSON_Delete(doc);
+                return 0;
+            }
+        } else {
+            root.ptr = doc;
+            benchmark_tick_begin();
+            *found = json_path_eval(path, &path_adapter, root);
+            benchmark_tick_end();
+        }
+    }
+    
+    cJSON_Delete(doc);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// index
+
+u64 index_measure_cjson(const char *json, size_t size, const usize *idxs,
+                        usize idx_count, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    cJSON *doc = cJSON_ParseWithLength(json, size);
+    if (!doc) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize n = 0; n < idx_count; n++) {
+            num += cJSON_GetArrayItem(doc, (int)idxs[n]) != NULL;
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    cJSON_Delete(doc);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// mutate
+
+#define MUTATE_KEY_MAX 256
+
+static void mutate_val(cJSON *val, usize *ops) {
+    cJSON *child;
+    if (cJSON_IsObject(val)) {
+        cJSON *first = val->child, *mid = NULL, *last = NULL;
+        usize n = 0, idx = 0;
+        cJSON_ArrayForEach(child, val) n++;
+        cJSON_ArrayForEach(child, val) {
+            if (idx++ == n / 2) mid = child;
+            last = child;
+            mutate_val(child, ops);
+        }
+        if (n >= 1) {
+            cJSON_ReplaceItemInObjectCaseSensitive(val, last->string, cJSON_CreateNumber((f64)n));
+            (*ops)++;
+        }
+        if (n >= 3) {
+            cJSON_Delete(cJSON_DetachItemViaPointer(val, mid));
+            (*ops)++;
+        }
+        if (n >= 1) {
+            // no rename API, replace the key string of the item
+            first = val->child;
+            usize len = strlen(first->string);
+            if (len > MUTATE_KEY_MAX - 2) len = MUTATE_KEY_MAX - 2;
+            char *key = malloc(len + 2);
+            if (!key) return;
+            key[0] = '_';
+            memcpy(key + 1, first->string, len);
+            key[len + 1] = '\0';
+            if (!(first->type & cJSON_StringIsConst)) free(first->string);
+            first->type &= ~cJSON_StringIsConst;
+            first->string = key;
+            (*ops)++;
+        }
+        cJSON_AddNumberToObject(val, "_id", (f64)n);
+        (*ops)++;
+    } else if (cJSON_IsArray(val)) {
+        usize n = 0;
+        cJSON_ArrayForEach(child, val) {
+            n++;
+            mutate_val(child, ops);
+        }
+        cJSON_AddItemToArray(val, cJSON_CreateNumber((f64)n));
+        (*ops)++;
+        if (n >= 2) {
+            // detach the range in one walk, deleting by index walks from the head each time
+            cJSON *item = cJSON_GetArrayItem(val, (int)(n / 4));
+            for (usize i = n / 4; i < n / 2 && item; i++) {
+                cJSON *next = item->next;
+                cJSON_Delete(cJSON_DetachItemViaPointer(val, item));
+                item = next;
+            }
+            cJSON_InsertItemInArray(val, 0, cJSON_CreateString("spliced"));
+            (*ops)++;
+        }
+    } else if (cJSON_IsNumber(val)) {
+        cJSON_SetNumberValue(val, val->valuedouble + 1);
+        (*ops)++;
+    } else if (cJSON_IsBool(val)) {
+        val->type = (val->type & ~(cJSON_True | cJSON_False)) |
+                    (cJSON_IsTrue(val) ? cJSON_False : cJSON_True);
+        (*ops)++;
+    }
+}
+
+u64 mutate_measure_cjson(const char *json, size_t size, bool write,
+                         usize *ops, size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        cJSON *doc = cJSON_ParseWithLength(json, size);
+        if (!doc) return 0;
+        
+        usize num = 0;
+        if (!write) {
+            benchmark_tick_begin();
+            mutate_val(doc, &num);
+            benchmark_tick_end();
+        } else {
+            mutate_val(doc, &num);
+            benchmark_tick_begin();
+            char *str = cJSON_PrintUnformatted(doc);
+            benchmark_tick_end();
+            if (!str) {
+                cJSON_Delete(doc);
+                return 0;
+            }
+            *out_size = strlen(str);
+            free(str);
+        }
+        *ops = num;
+        cJSON_Delete(doc);
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// patch
+
+static json_path_type patch_get_type(void *val) {
+    json_path_val v = { val, 0 };
+    return path_get_type(v);
+}
+
+static bool patch_get_bool(void *val) {
+    return cJSON_IsTrue((const cJSON *)val);
+}
+
+static f64 patch_get_num(void *val) {
+    return ((const cJSON *)val)->valuedouble;
+}
+
+static const char *patch_get_str(void *val, usize *len) {
+    const char *str = ((const cJSON *)val)->valuestring;
+    *len = strlen(str);
+    return str;
+}
+
+static usize patch_size(void *ctn) {
+    return (usize)cJSON_GetArraySize((const cJSON *)ctn);
+}
+
+static void *patch_arr_get(void *arr, usize idx) {
+    return cJSON_GetArrayItem((const cJSON *)arr, (int)idx);
+}
+
+static void *patch_obj_get(void *obj, const char *key, usize key_len) {
+    return cJSON_GetObjectItemCaseSensitive((const cJSON *)obj, key);
+}
+
+static bool patch_obj_foreach(void *obj, json_patch_each_func func, void *each_ctx) {
+    cJSON *v;
+    cJSON_ArrayForEach(v, (cJSON *)obj) {
+        if (!func(each_ctx, v->string, strlen(v->string), v)) return false;
+    }
+    return true;
+}
+
+static void *patch_dup(void *ctx, void *val) {
+    return cJSON_Duplicate((const cJSON *)val, true);
+}
+
+static void *patch_new_obj(void *ctx) {
+    return cJSON_CreateObject();
+}
+
+static void patch_release(void *ctx, void *val) {
+    cJSON_Delete((cJSON *)val);
+}
+
+static bool patch_obj_put(void *ctx, void *obj, const char *key, usize key_len,
+                          void *val) {
+    if (cJSON_GetObjectItemCaseSensitive((const cJSON *)obj, key)) {
+        return cJSON_ReplaceItemInObjectCaseSensitive((cJSON *)obj, key, (cJSON *)val);
+    }
+    return cJSON_AddItemToObject((cJSON *)obj, key, (cJSON *)val);
+}
+
+static void *patch_obj_remove(void *ctx, void *obj, const char *key, usize key_len) {
+    return cJSON_DetachItemFromObjectCaseSensitive((cJSON *)obj, key);
+}
+
+static bool patch_arr_insert(void *ctx, void *arr, usize idx, void *val) {
+    if (idx == patch_size(arr)) return cJSON_AddItemToArray((cJSON *)arr, (cJSON *)val);
+    return cJSON_InsertItemInArray((cJSON *)arr, (int)idx, (cJSON *)val);
+}
+
+static void *patch_arr_remove(void *ctx, void *arr, usize idx) {
+    return cJSON_DetachItemFromArray((cJSON *)arr, (int)idx);
+}
+
+static const json_patch_adapter patch_adapter = {
+    NULL, patch_get_type, patch_get_bool, patch_get_num, patch_get_str,
+    patch_size, patch_arr_get, patch_obj_get, patch_obj_foreach,
+    patch_dup, patch_new_obj, patch_release,
+    patch_obj_put, patch_obj_remove, patch_arr_insert, patch_arr_remove
+};
+
+u64 patch_measure_cjson(const char *json, size_t size, const char *patch,
+                        size_t patch_size, bool merge, int repeat) {
+    benchmark_tick_init();
+    
+    cJSON *doc = cJSON_ParseWithLength(json, size);
+    cJSON *pdoc = cJSON_ParseWithLength(patch, patch_size);
+    if (!doc || !pdoc) {
+        cJSON_Delete(doc);
+        cJSON_Delete(pdoc);
+        return 0;
+    }
+    
+    for (int i = 0; i < repeat; i++) {
+        bool suc;
+        benchmark_tick_begin();
+        cJSON *tmp = cJSON_Duplicate(doc, true);
+        if (merge) suc = json_merge_patch_apply(&patch_adapter, tmp, pdoc);
+        else suc = json_patch_apply(&patch_adapter, tmp, pdoc);
+        benchmark_tick_end();
+        cJSON_Delete(tmp);
+        if (!suc) {
+            cJSON_Delete(doc);
+            cJSON_Delete(pdoc);
+            return 0;
+        }
+    }
+    
+    cJSON_Delete(doc);
+    cJSON_Delete(pdoc);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// build
+
+/* Add with a copied key, or a borrowed (const) key. */
+static yy_inline void build_add(cJSON *obj, const char *key, cJSON *val, bool copy) {
+    if (copy) cJSON_AddItemToObject(obj, key, val);
+    else cJSON_AddItemToObjectCS(obj, key, val);
+}
+
+static yy_inline cJSON *build_str_val(build_str str, bool copy) {
+    if (!str.str) return cJSON_CreateNull();
+    if (copy) return cJSON_CreateString(str.str);
+    return cJSON_CreateStringReference(str.str);
+}
+
+static yy_inline void build_add_str(cJSON *obj, const char *key, build_str str, bool copy) {
+    build_add(obj, key, build_str_val(str, copy), copy);
+}
+
+static yy_inline void build_add_num(cJSON *obj, const char *key, f64 num, bool copy) {
+    build_add(obj, key, cJSON_CreateNumber(num), copy);
+}
+
+static yy_inline void build_add_bool(cJSON *obj, const char *key, bool b, bool copy) {
+    build_add(obj, key, cJSON_CreateBool(b), copy);
+}
+
+static yy_inline void build_add_id(cJSON *obj, const char *key, u64 id, bool copy) {
+    build_add(obj, key, id ? cJSON_CreateNumber((f64)id) : cJSON_CreateNull(), copy);
+}
+
+static yy_inline cJSON *build_add_new(cJSON *obj, const char *key, cJSON *val, bool copy) {
+    build_add(obj, key, val, copy);
+    return val;
+}
+
+static yy_inline void build_add_uints(cJSON *obj, const char *key, const u64 *vals,
+                                      usize count, bool copy) {
+    cJSON *arr = build_add_new(obj, key, cJSON_CreateArray(), copy);
+    for (usize i = 0; i < count; i++) cJSON_AddItemToArray(arr, cJSON_CreateNumber((f64)vals[i]));
+}
+
+static cJSON *build_twitter_doc(const build_twitter *tw, bool copy) {
+    cJSON *root = cJSON_CreateObject();
+    cJSON *statuses = build_add_new(root, "statuses", cJSON_CreateArray(), copy);
+    for (usize i = 0; i < tw->status_count; i++) {
+        const build_status *s = tw->statuses + i;
+        const build_user *u = &s->user;
+        cJSON *st = cJSON_CreateObject();
+        cJSON_AddItemToArray(statuses, st);
+        build_add_str(st, "created_at", s->created_at, copy);
+        build_add_num(st, "id", (f64)s->id, copy);
+        build_add_str(st, "id_str", s->id_str, copy);
+        build_add_str(st, "text", s->text, copy);
+        build_add_str(st, "source", s->source, copy);
+        build_add_bool(st, "truncated", s->truncated, copy);
+        build_add_id(st, "in_reply_to_status_id", s->in_reply_to_status_id, copy);
+        build_add_str(st, "in_reply_to_status_id_str", s->in_reply_to_status_id_str, copy);
+        build_add_id(st, "in_reply_to_user_id", s->in_reply_to_user_id, copy);
+        build_add_str(st, "in_reply_to_user_id_str", s->in_reply_to_user_id_str, copy);
+        build_add_str(st, "in_reply_to_screen_name", s->in_reply_to_screen_name, copy);
+        
+        cJSON *user = build_add_new(st, "user", cJSON_CreateObject(), copy);
+        build_add_num(user, "id", (f64)u->id, copy);
+        build_add_str(user, "id_str", u->id_str, copy);
+        build_add_str(user, "name", u->name, copy);
+        build_add_str(user, "screen_name", u->screen_name, copy);
+        build_add_str(user, "location", u->location, copy);
+        build_add_str(user, "description", u->description, copy);
+        build_add_bool(user, "protected", u->is_protected, copy);
+        build_add_num(user, "followers_count", (f64)u->followers_count, copy);
+        build_add_num(user, "friends_count", (f64)u->friends_count, copy);
+        build_add_num(user, "listed_count", (f64)u->listed_count, copy);
+        build_add_str(user, "created_at", u->created_at, copy);
+        build_add_num(user, "favourites_count", (f64)u->favourites_count, copy);
+        build_add_bool(user, "verified", u->verified, copy);
+        build_add_num(user, "statuses_count", (f64)u->statuses_count, copy);
+        build_add_str(user, "lang", u->lang, copy);
+        build_add_str(user, "profile_image_url", u->profile_image_url, copy);
+        
+        build_add_num(st, "retweet_count", (f64)s->retweet_count, copy);
+        build_add_num(st, "favorite_count", (f64)s->favorite_count, copy);
+        
+        cJSON *ent = build_add_new(st, "entities", cJSON_CreateObject(), copy);
+        cJSON *tags = build_add_new(ent, "hashtags", cJSON_CreateArray(), copy);
+        for (usize t = 0; t < s->hashtag_count; t++) {
+            cJSON *tag = cJSON_CreateObject();
+            cJSON_AddItemToArray(tags, tag);
+            build_add_str(tag, "text", s->hashtags[t].text, copy);
+            build_add_uints(tag, "indices", s->hashtags[t].indices, 2, copy);
+        }
+        cJSON *mens = build_add_new(ent, "user_mentions", cJSON_CreateArray(), copy);
+        for (usize m = 0; m < s->mention_count; m++) {
+            const build_mention *mention = s->mentions + m;
+            cJSON *men = cJSON_CreateObject();
+            cJSON_AddItemToArray(mens, men);
+            build_add_str(men, "screen_name", mention->screen_name, copy);
+            build_add_str(men, "name", mention->name, copy);
+            build_add_num(men, "id", (f64)mention->id, copy);
+            build_add_str(men, "id_str", mention->id_str, copy);
+            build_add_uints(men, "indices", mention->indices, 2, copy);
+        }
+        
+        build_add_bool(st, "favorited", s->favorited, copy);
+        build_add_bool(st, "retweeted", s->retweeted, copy);
+        build_add_str(st, "lang", s->lang, copy);
+    }
+    
+    cJSON *meta = build_add_new(root, "search_metadata", cJSON_CreateObject(), copy);
+    build_add_num(meta, "completed_in", tw->completed_in, copy);
+    build_add_num(meta, "max_id", (f64)tw->max_id, copy);
+    build_add_str(meta, "max_id_str", tw->max_id_str, copy);
+    build_add_str(meta, "next_results", tw->next_results, copy);
+    build_add_str(meta, "query", tw->query, copy);
+    build_add_str(meta, "refresh_url", tw->refresh_url, copy);
+    build_add_num(meta, "count", (f64)tw->count, copy);
+    build_add_num(meta, "since_id", (f64)tw->since_id, copy);
+    build_add_str(meta, "since_id_str", tw->since_id_str, copy);
+    return root;
+}
+
+static cJSON *build_citm_doc(const build_citm *citm, bool copy) {
+    cJSON *root = cJSON_CreateObject();
+    cJSON *events = build_add_new(root, "events", cJSON_CreateObject(), copy);
+    for (usize i = 0; i < citm->event_count; i++) {
+        const build_event *e = citm->events + i;
+        cJSON *evt = build_add_new(events, e->key.str, cJSON_CreateObject(), copy);
+        build_add(evt, "description", cJSON_CreateNull(), copy);
+        build_add_num(evt, "id", (f64)e->id, copy);
+        build_add_str(evt, "logo", e->logo, copy);
+        build_add_str(evt, "name", e->name, copy);
+        build_add_uints(evt, "subTopicIds", e->sub_topic_ids, e->sub_topic_count, copy);
+        build_add(evt, "subjectCode", cJSON_CreateNull(), copy);
+        build_add(evt, "subtitle", cJSON_CreateNull(), copy);
+        build_add_uints(evt, "topicIds", e->topic_ids, e->topic_count, copy);
+    }
+    
+    cJSON *perfs = build_add_new(root, "performances", cJSON_CreateArray(), copy);
+    for (usize i = 0; i < citm->performance_count; i++) {
+        const build_performance *p = citm->performances + i;
+        cJSON *perf = cJSON_CreateObject();
+        cJSON_AddItemToArray(perfs, perf);
+        build_add_num(perf, "eventId", (f64)p->event_id, copy);
+        build_add_num(perf, "id", (f64)p->id, copy);
+        build_add_str(perf, "logo", p->logo, copy);
+        build_add(perf, "name", cJSON_CreateNull(), copy);
+        cJSON *prices = build_add_new(perf, "prices", cJSON_CreateArray(), copy);
+        for (usize n = 0; n < p->price_count; n++) {
+            cJSON *price = cJSON_CreateObject();
+            cJSON_AddItemToArray(prices, price);
+            build_add_num(price, "amount", (f64)p->prices[n].amount, copy);
+            build_add_num(price, "audienceSubCategoryId",
+                          (f64)p->prices[n].audience_sub_category_id, copy);
+            build_add_num(price, "seatCategoryId", (f64)p->prices[n].seat_category_id, copy);
+        }
+        cJSON *cats = build_add_new(perf, "seatCategories", cJSON_CreateArray(), copy);
+        for (usize n = 0; n < p->seat_category_count; n++) {
+            const build_seat_category *c = p->seat_categories + n;
+            cJSON *cat = cJSON_CreateObject();
+            cJSON_AddItemToArray(cats, cat);
+            cJSON *areas = build_add_new(cat, "areas", cJSON_CreateArray(), copy);
+            for (usize a = 0; a < c->area_count; a++) {
+                cJSON *area = cJSON_CreateObject();
+                cJSON_AddItemToArray(areas, area);
+                build_add_num(area, "areaId", (f64)c->area_ids[a], copy);
+                build_add(area, "blockIds", cJSON_CreateArray(), copy);
+            }
+            build_add_num(cat, "seatCategoryId", (f64)c->seat_category_id, copy);
+        }
+        build_add(perf, "seatMapImage", cJSON_CreateNull(), copy);
+        build_add_num(perf, "start", (f64)p->start, copy);
+        build_add_str(perf, "venueCode", p->venue_code, copy);
+    }
+    
+    for (usize m = 0; m < citm->map_count; m++) {
+        const build_name_map *map = citm->maps + m;
+        cJSON *obj = build_add_new(root, map->name.str, cJSON_CreateObject(), copy);
+        for (usize n = 0; n < map->count; n++) {
+            build_add_str(obj, map->names[n].key.str, map->names[n].name, copy);
+        }
+    }
+    return root;
+}
+
+u64 build_measure_cjson(const build_data *data, bool copy, bool write,
+                        size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        char *str = NULL;
+        benchmark_tick_begin();
+        cJSON *root;
+        if (data->twitter) root = build_twitter_doc(data->twitter, copy);
+        else root = build_citm_doc(data->citm, copy);
+        if (write) str = cJSON_PrintUnformatted(root);
+        benchmark_tick_end();
+        cJSON_Delete(root);
+        if (write) {
+            if (!str) return 0;
+            *out_size = strlen(str);
+            free(str);
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// string
+
+u64 string_reader_measure_cjson(const char *json, size_t size, usize *len, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        usize sum = 0;
+        cJSON *val;
+        benchmark_tick_begin();
+        cJSON *doc = cJSON_ParseWithLength(json, size);
+        cJSON_ArrayForEach(val, doc) {
+            // the length is not stored
+            if (cJSON_IsString(val)) sum += strlen(val->valuestring);
+        }
+        benchmark_tick_end();
+        if (!doc) return 0;
+        cJSON_Delete(doc);
+        *len = sum;
+    }
+    
+    return benchmark_tick_min();
+}
+
+u64 string_writer_measure_cjson(const char *json, size_t size, string_escape esc,
+                                size_t *out_size, int repeat) {
+    // cJSON writes non-ASCII and slashes as is
+    if (esc != STRING_ESCAPE_DEFAULT) return 0;
+    
+    benchmark_tick_init();
+    
+    cJSON *doc = cJSON_ParseWithLength(json, size);
+    if (!doc) return 0;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        char *str = cJSON_PrintUnformatted(doc);
+        benchmark_tick_end();
+        if (!str) {
+            cJSON_Delete(doc);
+            return 0;
+        }
+        *out_size = strlen(str);
+        free(str);
+    }
+    cJSON_Delete(doc);
+    
+    return benchmark_tick_min();
+}
@@ -1,10 +1,18 @@
 #include "benchmark.h"
 #include "jansson.h"
 
+/* Pin the hash seed before the first object is created (later calls are
+   ignored), so the adversarial keys collide in the hashtable. It is called
+   once when the benchmarks are registered. */
+void jansson_pin_seed(void) {
+    json_object_seed(JANSSON_HASH_SEED);
+}
+
 // -----------------------------------------------------------------------------
 // reader
 
-u64 reader_measure_jansson(const char *json, size_t size, int repeat) {
+u64 reader_measure_jansson(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
     benchmark_tick_init();
     
     for (int i = 0; i < repeat; i++) {
@@ -16,6 +24,7 @@ u64 reader_measure_jansson(const char *json, size_t size, int repeat) {
         json_decref(root);
     }
     
+    *valid = true;
     return benchmark_tick_min();
 }
 
@@ -125,3 +134,809 @@ u64 stats_measure_jansson(const char *json, size_t size, stats_data *data, int r
     return benchmark_tick_min();
 }
 
+
+// -----------------------------------------------------------------------------
+// number reader
+
+u64 number_reader_measure_jansson(const number_data *data, f64 *vals,
+                                  bool single, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        json_error_t error;
+        if (single) {
+            benchmark_tick_begin();
+            for (usize n = 0; n < data->count; n++) {
+                json_t *root = json_loadb(data->strs[n], data->lens[n], JSON_DECODE_ANY, &error);
+                vals[n] = json_is_number(root) ? json_number_value(root) : NAN;
+                json_decref(root);
+            }
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            json_t *root = json_loadb(data->array, data->array_size, 0, &error);
+            size_t idx;
+            json_t *val;
+            json_array_foreach(root, idx, val) {
+                vals[idx] = json_number_value(val);
+            }
+            benchmark_tick_end();
+            if (!root) return 0;
+            json_decref(root);
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// number writer
+
+u64 number_writer_measure_jansson(const number_values *vals, char **out,
+                                  usize *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    json_t *root = json_array();
+    for (usize n = 0; n < vals->count; n++) {
+        if (vals->is_int) json_array_append_new(root, json_integer((json_int_t)vals->ints[n]));
+        else json_array_append_new(root, json_real(vals->reals[n]));
+    }
+    
+    char *str = NULL;
+    for (int i = 0; i < repeat; i++) {
+        free(str);
+        benchmark_tick_begin();
+        str = json_dumps(root, JSON_COMPACT);
+        benchmark_tick_end();
+        if (!str) break;
+    }
+    json_decref(root);
+    
+    *out = str;
+    *out_size = str ? strlen(str) : 0;
+    return str ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// roundtrip
+
+u64 roundtrip_measure_jansson(const char *json, size_t size, size_t *out_size,
+                              bool *roundtrip, int repeat) {
+    benchmark_tick_init();
+    
+    *roundtrip = true;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        json_error_t error;
+        json_t *root = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+        char *str = root ? json_dumps(root, JSON_ENCODE_ANY | JSON_COMPACT) : NULL;
+        json_decref(root);
+        benchmark_tick_end();
+        if (!str) return 0;
+        *out_size = strlen(str);
+        if (*out_size != size || memcmp(json, str, size) != 0) *roundtrip = false;
+        free(str);
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// lookup
+
+static json_t *lookup_resolve(json_t *val, const lookup_target *target) {
+    for (usize d = 0; d < target->depth && val; d++) {
+        if (json_is_array(val)) {
+            val = json_array_get(val, (size_t)strtoull(target->path[d], NULL, 10));
+        } else {
+            val = json_object_get(val, target->path[d]);
+        }
+    }
+    return val;
+}
+
+u64 lookup_measure_jansson(const char *json, size_t size,
+                           const lookup_target *targets, usize target_count,
+                           usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    json_error_t error;
+    json_t *root = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+    if (!root) return 0;
+    json_t **objs = malloc((target_count + 1) * sizeof(json_t *));
+    bool suc = true;
+    for (usize t = 0; t < target_count; t++) {
+        objs[t] = lookup_resolve(root, targets + t);
+        if (!json_is_object(objs[t])) suc = false;
+    }
+    
+    // hash table lookup
+    for (int i = 0; i < repeat && suc; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize t = 0; t < target_count; t++) {
+            const lookup_target *target = targets + t;
+            for (usize k = 0; k < target->key_count; k++) {
+                num += json_object_get(objs[t], target->keys[k]) != NULL;
+            }
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    free(objs);
+    json_decref(root);
+    return suc ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// pointer (shared pointer parser)
+
+#define POINTER_MAX_TOKENS 64
+
+static yy_inline json_t *pointer_walk(json_t *val, const json_ptr_token *tokens, usize count) {
+    for (usize t = 0; t < count && val; t++) {
+        usize idx;
+        if (json_is_object(val)) {
+            val = json_object_get(val, tokens[t].str);
+        } else if (json_is_array(val) && json_pointer_token_to_index(tokens + t, &idx)) {
+            val = json_array_get(val, idx);
+        } else {
+            val = NULL;
+        }
+    }
+    return val;
+}
+
+u64 pointer_measure_jansson(const char *json, size_t size, const pointer_data *data,
+                            bool walk_only, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    json_error_t error;
+    json_t *root = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+    if (!root) return 0;
+    usize buf_len = 0;
+    for (usize p = 0; p < data->count; p++) {
+        if (data->lens[p] > buf_len) buf_len = data->lens[p];
+    }
+    char *buf = malloc(buf_len + 1);
+    json_ptr_token tokens[POINTER_MAX_TOKENS];
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        if (walk_only) {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                num += pointer_walk(root, data->tokens[p], data->token_counts[p]) != NULL;
+            }
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                usize count = json_pointer_parse(data->ptrs[p], data->lens[p], buf,
+                                                 tokens, POINTER_MAX_TOKENS);
+                if (count == SIZE_MAX) continue;
+                num += pointer_walk(root, tokens, count) != NULL;
+            }
+            benchmark_tick_end();
+        }
+        *found = num;
+    }
+    
+    free(buf);
+    json_decref(root);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// path
+
+static json_path_type path_get_type(json_path_val val) {
+    switch (json_typeof((const json_t *)val.ptr)) {
+        case JSON_NULL: return JSON_PATH_NULL;
+        case JSON_TRUE:
+        case JSON_FALSE: return JSON_PATH_BOOL;
+        case JSON_INTEGER:
+        case JSON_REAL: return JSON_PATH_NUM;
+        case JSON_STRING: return JSON_PATH_STR;
+        case JSON_ARRAY: return JSON_PATH_ARR;
+        case JSON_OBJECT: return JSON_PATH_OBJ;
+        default: return JSON_PATH_NONE;
+    }
+}
+
+static bool path_get_bool(json_path_val val) {
+    return json_is_true((const json_t *)val.ptr);
+}
+
+static f64 path_get_num(json_path_val val) {
+    return json_number_value((const json_t *)val.ptr);
+}
+
+static const char *path_get_str(json_path_val val, usize *len) {
+    *len = json_string_length((const json_t *)val.ptr);
+    return json_string_value((const json_t *)val.ptr);
+}
+
+static usize path_arr_size(json_path_val val) {
+    return json_array_size((const json_t *)val.ptr);
+}
+
+static bool path_arr_get(json_path_val val, usize idx, json_path_val *out) {
+    out->ptr = json_array_get((const json_t *)val.ptr, idx);
+    return out->ptr != NULL;
+}
+
+static bool path_obj_get(json_path_val val, const char *key, usize key_len,
+                         json_path_val *out) {
+    out->ptr = json_object_get((const json_t *)val.ptr, key);
+    return out->ptr != NULL;
+}
+
+static void path_foreach(json_path_val val, json_path_each_func func, void *ctx) {
+    json_t *ctn = (json_t *)val.ptr, *v;
+    json_path_val sub = { NULL, 0 };
+    if (json_is_object(ctn)) {
+        const char *k;
+        json_object_foreach(ctn, k, v) {
+            sub.ptr = v;
+            func(ctx, k, strlen(k), sub);
+        }
+    } else {
+        usize idx;
+        json_array_foreach(ctn, idx, v) {
+            sub.ptr = v;
+            func(ctx, NULL, 0, sub);
+        }
+    }
+}
+
+static const json_path_adapter path_adapter = {
+    path_get_type, path_get_bool, path_get_num, path_get_str,
+    path_arr_size, path_arr_get, path_obj_get, path_foreach
+};
+
+u64 path_measure_jansson(const char *json, size_t size, const json_path *path,
+                         bool with_parse, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    json_error_t error;
+    json_t *doc = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+    if (!doc) return 0;
+    json_path_val root = { NULL, 0 };
+    
+    for (int i = 0; i < repeat; i++) {
+        if (with_parse) {
+            benchmark_tick_begin();
+            json_t *tmp = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+            root.ptr = tmp;
+            if (tmp) *found = json_path_eval(path, &path_adapter, root);
+            json_decref(tmp);
+            benchmark_tick_end();
+            if (!tmp) {
+                json_decref(doc);
+                return 0;
+            }
+        } else {
+            root.ptr = doc;
+            benchmark_tick_begin();
+            *found = json_path_eval(path, &path_adapter, root);
+            benchmark_tick_end();
+        }
+    }
+    
+    json_decref(doc);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// index
+
+u64 index_measure_jansson(const char *json, size_t size, const usize *idxs,
+                          usize idx_count, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    json_error_t error;
+    json_t *root = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+    if (!root) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize n = 0; n < idx_count; n++) {
+            num += json_array_get(root, idxs[n]) != NULL;
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    json_decref(root);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// mutate
+
+#define MUTATE_KEY_MAX 256
+
+/* Returns a new value if the scalar cannot be changed in place (bool). */
+static json_t *mutate_scalar(json_t *val, usize *ops) {
+    if (json_is_integer(val)) {
+        json_integer_set(val, json_integer_value(val) + 1);
+        (*ops)++;
+    } else if (json_is_real(val)) {
+        json_real_set(val, json_real_value(val) + 1);
+        (*ops)++;
+    } else if (json_is_boolean(val)) {
+        (*ops)++;
+        return json_boolean(!json_is_true(val));
+    }
+    return NULL;
+}
+
+static void mutate_val(json_t *val, usize *ops) {
+    json_t *v, *rep;
+    if (json_is_object(val)) {
+        const char *first = NULL, *mid = NULL, *last = NULL;
+        usize n = json_object_size(val), idx = 0;
+        void *iter = json_object_iter(val);
+        for (; iter; iter = json_object_iter_next(val, iter), idx++) {
+            const char *k = json_object_iter_key(iter);
+            if (idx == 0) first = k;
+            if (idx == n / 2) mid = k;
+            last = k;
+            v = json_object_iter_value(iter);
+            mutate_val(v, ops);
+            if ((rep = mutate_scalar(v, ops))) json_object_iter_set_new(val, iter, rep);
+        }
+        if (n >= 1) {
+            json_object_set_new(val, last, json_integer((json_int_t)n));
+            (*ops)++;
+        }
+        if (n >= 3) {
+            json_object_del(val, mid);
+            (*ops)++;
+        }
+        if (n >= 1) {
+            // no rename API, move the value to a new key (appended to the end)
+            char buf[MUTATE_KEY_MAX];
+            usize len = strlen(first);
+            if (len > MUTATE_KEY_MAX - 2) len = MUTATE_KEY_MAX - 2;
+            buf[0] = '_';
+            memcpy(buf + 1, first, len);
+            buf[len + 1] = '\0';
+            v = json_incref(json_object_get(val, first));
+            json_object_del(val, first);
+            json_object_set_new(val, buf, v);
+            (*ops)++;
+        }
+        json_object_set_new(val, "_id", json_integer((json_int_t)n));
+        (*ops)++;
+    } else if (json_is_array(val)) {
+        usize n = json_array_size(val), idx;
+        json_array_foreach(val, idx, v) {
+            mutate_val(v, ops);
+            if ((rep = mutate_scalar(v, ops))) json_array_set_new(val, idx, rep);
+        }
+        json_array_append_new(val, json_integer((json_int_t)n));
+        (*ops)++;
+        if (n >= 2) {
+            // move the tail over the range in one pass, then drop the last items,
+            // removing from the middle moves the tail each time
+            usize cnt = n / 2 - n / 4, size = json_array_size(val);
+            for (usize i = n / 4; i + cnt < size; i++) {
+                json_array_set(val, i, json_array_get(val, i + cnt));
+            }
+            for (usize i = 0; i < cnt; i++) json_array_remove(val, size - 1 - i);
+            json_array_insert_new(val, 0, json_string("spliced"));
+            (*ops)++;
+        }
+    }
+}
+
+u64 mutate_measure_jansson(const char *json, size_t size, bool write,
+                           usize *ops, size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        json_error_t error;
+        json_t *root = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+        if (!root) return 0;
+        
+        usize num = 0;
+        json_t *rep;
+        if (!write) {
+            benchmark_tick_begin();
+            mutate_val(root, &num);
+            rep = mutate_scalar(root, &num);
+            benchmark_tick_end();
+        } else {
+            mutate_val(root, &num);
+            rep = mutate_scalar(root, &num);
+        }
+        if (rep) {
+            json_decref(root);
+            root = rep;
+        }
+        if (write) {
+            benchmark_tick_begin();
+            char *str = json_dumps(root, JSON_COMPACT | JSON_ENCODE_ANY);
+            benchmark_tick_end();
+            if (!str) {
+                json_decref(root);
+                return 0;
+            }
+            *out_size = strlen(str);
+            free(str);
+        }
+        *ops = num;
+        json_decref(root);
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// patch
+
+static json_path_type patch_get_type(void *val) {
+    json_path_val v = { val, 0 };
+    return path_get_type(v);
+}
+
+static bool patch_get_bool(void *val) {
+    return json_is_true((const json_t *)val);
+}
+
+static f64 patch_get_num(void *val) {
+    return json_number_value((const json_t *)val);
+}
+
+static const char *patch_get_str(void *val, usize *len) {
+    *len = json_string_length((const json_t *)val);
+    return json_string_value((const json_t *)val);
+}
+
+static usize patch_size(void *ctn) {
+    const json_t *v = (const json_t *)ctn;
+    return json_is_object(v) ? json_object_size(v) : json_array_size(v);
+}
+
+static void *patch_arr_get(void *arr, usize idx) {
+    return json_array_get((const json_t *)arr, idx);
+}
+
+static void *patch_obj_get(void *obj, const char *key, usize key_len) {
+    return json_object_get((const json_t *)obj, key);
+}
+
+static bool patch_obj_foreach(void *obj, json_patch_each_func func, void *each_ctx) {
+    const char *k;
+    json_t *v;
+    json_object_foreach((json_t *)obj, k, v) {
+        if (!func(each_ctx, k, strlen(k), v)) return false;
+    }
+    return true;
+}
+
+static void *patch_dup(void *ctx, void *val) {
+    return json_deep_copy((const json_t *)val);
+}
+
+static void *patch_new_obj(void *ctx) {
+    return json_object();
+}
+
+static void patch_release(void *ctx, void *val) {
+    json_decref((json_t *)val);
+}
+
+/* The *_new functions steal the reference even on failure, so use the plain
+   ones and drop the caller's reference on success. */
+static bool patch_obj_put(void *ctx, void *obj, const char *key, usize key_len,
+                          void *val) {
+    if (json_object_set((json_t *)obj, key, (json_t *)val) != 0) return false;
+    json_decref((json_t *)val);
+    return true;
+}
+
+static void *patch_obj_remove(void *ctx, void *obj, const char *key, usize key_len) {
+    json_t *val = json_object_get((json_t *)obj, key);
+    if (!val) return NULL;
+    json_incref(val);
+    json_object_del((json_t *)obj, key);
+    return val;
+}
+
+static bool patch_arr_insert(void *ctx, void *arr, usize idx, void *val) {
+    if (json_array_insert((json_t *)arr, idx, (json_t *)val) != 0) return false;
+    json_decref((json_t *)val);
+    return true;
+}
+
+static void *patch_arr_remove(void *ctx, void *arr, usize idx) {
+    json_t *val = json_array_get((json_t *)arr, idx);
+    if (!val) return NULL;
+    json_incref(val);
+    json_array_remove((json_t *)arr, idx);
+    return val;
+}
+
+static const json_patch_adapter patch_adapter = {
+    NULL, patch_get_type, patch_get_bool, patch_get_num, patch_get_str,
+    patch_size, patch_arr_get, patch_obj_get, patch_obj_foreach,
+    patch_dup, patch_new_obj, patch_release,
+    patch_obj_put, patch_obj_remove, patch_arr_insert, patch_arr_remove
+};
+
+u64 patch_measure_jansson(const char *json, size_t size, const char *patch,
+                          size_t patch_size, bool merge, int repeat) {
+    benchmark_tick_init();
+    
+    json_error_t error;
+    json_t *root = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+    json_t *ops = json_loadb(patch, patch_size, JSON_DECODE_ANY, &error);
+    if (!root || !ops) {
+        json_decref(root);
+        json_decref(ops);
+        return 0;
+    }
+    
+    for (int i = 0; i < repeat; i++) {
+        bool suc;
+        benchmark_tick_begin();
+        json_t *tmp = json_deep_copy(root);
+        if (merge) suc = json_merge_patch_apply(&patch_adapter, tmp, ops);
+        else suc = json_patch_apply(&patch_adapter, tmp, ops);
+        benchmark_tick_end();
+        json_decref(tmp);
+        if (!suc) {
+            json_decref(root);
+            json_decref(ops);
+            return 0;
+        }
+    }
+    
+    json_decref(root);
+    json_decref(ops);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// build
+
+static yy_inline json_t *build_id(u64 id) {
+    return id ? json_integer((json_int_t)id) : json_null();
+}
+
+static yy_inline json_t *build_uints(const u64 *vals, usize count) {
+    json_t *arr = json_array();
+    for (usize i = 0; i < count; i++) json_array_append_new(arr, json_integer((json_int_t)vals[i]));
+    return arr;
+}
+
+static json_t *build_twitter_doc(const build_twitter *tw) {
+    json_t *statuses = json_array();
+    for (usize i = 0; i < tw->status_count; i++) {
+        const build_status *s = tw->statuses + i;
+        const build_user *u = &s->user;
+        json_t *user = json_pack(
+            "{s:I, s:s?, s:s?, s:s?, s:s?, s:s?, s:b, s:I, s:I, s:I, s:s?, s:I, s:b, s:I, s:s?, s:s?}",
+            "id", (json_int_t)u->id,
+            "id_str", u->id_str.str,
+            "name", u->name.str,
+            "screen_name", u->screen_name.str,
+            "location", u->location.str,
+            "description", u->description.str,
+            "protected", (int)u->is_protected,
+            "followers_count", (json_int_t)u->followers_count,
+            "friends_count", (json_int_t)u->friends_count,
+            "listed_count", (json_int_t)u->listed_count,
+            "created_at", u->created_at.str,
+            "favourites_count", (json_int_t)u->favourites_count,
+            "verified", (int)u->verified,
+            "statuses_count", (json_int_t)u->statuses_count,
+            "lang", u->lang.str,
+            "profile_image_url", u->profile_image_url.str);
+        
+        json_t *tags = json_array();
+        for (usize t = 0; t < s->hashtag_count; t++) {
+            const build_hashtag *tag = s->hashtags + t;
+            json_array_append_new(tags, json_pack("{s:s?, s:[II]}",
+                "text", tag->text.str,
+                "indices", (json_int_t)tag->indices[0], (json_int_t)tag->indices[1]));
+        }
+        json_t *mens = json_array();
+        for (usize m = 0; m < s->mention_count; m++) {
+            const build_mention *men = s->mentions + m;
+            json_array_append_new(mens, json_pack("{s:s?, s:s?, s:I, s:s?, s:[II]}",
+                "screen_name", men->screen_name.str,
+                "name", men->name.str,
+                "id", (json_int_t)men->id,
+                "id_str", men->id_str.str,
+                "indices", (json_int_t)men->indices[0], (json_int_t)men->indices[1]));
+        }
+        
+        json_array_append_new(statuses, json_pack(
+            "{s:s?, s:I, s:s?, s:s?, s:s?, s:b, s:o, s:s?, s:o, s:s?, s:s?, s:o, s:I, s:I, "
+            "s:{s:o, s:o}, s:b, s:b, s:s?}",
+            "created_at", s->created_at.str,
+            "id", (json_int_t)s->id,
+            "id_str", s->id_str.str,
+            "text", s->text.str,
+            "source", s->source.str,
+            "truncated", (int)s->truncated,
+            "in_reply_to_status_id", build_id(s->in_reply_to_status_id),
+            "in_reply_to_status_id_str", s->in_reply_to_status_id_str.str,
+            "in_reply_to_user_id", build_id(s->in_reply_to_user_id),
+            "in_reply_to_user_id_str", s->in_reply_to_user_id_str.str,
+            "in_reply_to_screen_name", s->in_reply_to_screen_name.str,
+            "user", user,
+            "retweet_count", (json_int_t)s->retweet_count,
+            "favorite_count", (json_int_t)s->favorite_count,
+            "entities", "hashtags", tags, "user_mentions", mens,
+            "favorited", (int)s->favorited,
+            "retweeted", (int)s->retweeted,
+            "lang", s->lang.str));
+    }
+    
+    return json_pack("{s:o, s:{s:f, s:I, s:s?, s:s?, s:s?, s:s?, s:I, s:I, s:s?}}",
+        "statuses", statuses,
+        "search_metadata",
+        "completed_in", tw->completed_in,
+        "max_id", (json_int_t)tw->max_id,
+        "max_id_str", tw->max_id_str.str,
+        "next_results", tw->next_results.str,
+        "query", tw->query.str,
+        "refresh_url", tw->refresh_url.str,
+        "count", (json_int_t)tw->count,
+        "since_id", (json_int_t)tw->since_id,
+        "since_id_str", tw->since_id_str.str);
+}
+
+static json_t *build_citm_doc(const build_citm *citm) {
+    json_t *events = json_object();
+    for (usize i = 0; i < citm->event_count; i++) {
+        const build_event *e = citm->events + i;
+        json_object_set_new(events, e->key.str, json_pack(
+            "{s:n, s:I, s:s?, s:s?, s:o, s:n, s:n, s:o}",
+            "description",
+            "id", (json_int_t)e->id,
+            "logo", e->logo.str,
+            "name", e->name.str,
+            "subTopicIds", build_uints(e->sub_topic_ids, e->sub_topic_count),
+            "subjectCode",
+            "subtitle",
+            "topicIds", build_uints(e->topic_ids, e->topic_count)));
+    }
+    
+    json_t *perfs = json_array();
+    for (usize i = 0; i < citm->performance_count; i++) {
+        const build_performance *p = citm->performances + i;
+        json_t *prices = json_array();
+        for (usize n = 0; n < p->price_count; n++) {
+            json_array_append_new(prices, json_pack("{s:I, s:I, s:I}",
+                "amount", (json_int_t)p->prices[n].amount,
+                "audienceSubCategoryId", (json_int_t)p->prices[n].audience_sub_category_id,
+                "seatCategoryId", (json_int_t)p->prices[n].seat_category_id));
+        }
+        json_t *cats = json_array();
+        for (usize n = 0; n < p->seat_category_count; n++) {
+            const build_seat_category *c = p->seat_categories + n;
+            json_t *areas = json_array();
+            for (usize a = 0; a < c->area_count; a++) {
+                json_array_append_new(areas, json_pack("{s:I, s:[]}",
+                    "areaId", (json_int_t)c->area_ids[a], "blockIds"));
+            }
+            json_array_append_new(cats, json_pack("{s:o, s:I}",
+                "areas", areas, "seatCategoryId", (json_int_t)c->seat_category_id));
+        }
+        json_array_append_new(perfs, json_pack("{s:I, s:I, s:s?, s:n, s:o, s:o, s:n, s:I, s:s?}",
+            "eventId", (json_int_t)p->event_id,
+            "id", (json_int_t)p->id,
+            "logo", p->logo.str,
+            "name",
+            "prices", prices,
+            "seatCategories", cats,
+            "seatMapImage",
+            "start", (json_int_t)p->start,
+            "venueCode", p->venue_code.str));
+    }
+    
+    json_t *root = json_pack("{s:o, s:o}", "events", events, "performances", perfs);
+    for (usize m = 0; m < citm->map_count; m++) {
+        const build_name_map *map = citm->maps + m;
+        json_t *obj = json_object();
+        for (usize n = 0; n < map->count; n++) {
+            json_object_set_new(obj, map->names[n].key.str, json_string(map->names[n].name.str));
+        }
+        json_object_set_new(root, map->name.str, obj);
+    }
+    return root;
+}
+
+u64 build_measure_jansson(const build_data *data, bool copy, bool write,
+                          size_t *out_size, int repeat) {
+    if (!copy) return 0; // jansson always copies the strings
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        char *str = NULL;
+        benchmark_tick_begin();
+        json_t *root;
+        if (data->twitter) root = build_twitter_doc(data->twitter);
+        else root = build_citm_doc(data->citm);
+        if (root && write) str = json_dumps(root, JSON_COMPACT);
+        benchmark_tick_end();
+        json_decref(root);
+        if (!root) return 0;
+        if (write) {
+            if (!str) return 0;
+            *out_size = strlen(str);
+            free(str);
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// string
+
+u64 string_reader_measure_jansson(const char *json, size_t size, usize *len, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        usize sum = 0, idx;
+        json_t *val;
+        json_error_t error;
+        benchmark_tick_begin();
+        json_t *root = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+        json_array_foreach(root, idx, val) {
+            sum += json_string_length(val);
+        }
+        benchmark_tick_end();
+        if (!root) return 0;
+        json_decref(root);
+        *len = sum;
+    }
+    
+    return benchmark_tick_min();
+}
+
+u64 string_writer_measure_jansson(const char *json, size_t size, string_escape esc,
+                                  size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    json_error_t error;
+    json_t *root = json_loadb(json, size, JSON_DECODE_ANY | JSON_ALLOW_NUL, &error);
+    if (!root) return 0;
+    
+    size_t flag = JSON_ENCODE_ANY | JSON_COMPACT;
+    if (esc == STRING_ESCAPE_UNICODE) flag |= JSON_ENSURE_ASCII;
+    if (esc == STRING_ESCAPE_SLASHES) flag |= JSON_ESCAPE_SLASH;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        char *str = json_dumps(root, flag);
+        benchmark_tick_end();
+        if (!str) {
+            json_decref(root);
+            return 0;
+        }
+        *out_size = strlen(str);
+        free(str);
+    }
+    json_decref(root);
+    
+    return benchmark_tick_min();
+}
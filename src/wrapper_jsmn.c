@@ -0,0 +1,167 @@
+#include "benchmark.h"
+#include <limits.h>
+#define JSMN_STATIC
+#define JSMN_STRICT
+#include "jsmn.h"
+
+/*
+ jsmn only splits the input into tokens (type and offsets), it does not decode
+ strings or numbers. The token array is provided by the caller, so the reader
+ is measured with a counting pass to size the array, and with a fixed arena
+ sized for the worst case, allocated once.
+ */
+
+/* The max token count of `size` bytes input, every token takes at least one
+   byte and a separator (or a close bracket). */
+static yy_inline usize jsmn_max_tokens(size_t size) {
+    return size / 2 + 1;
+}
+
+/* Parse into the tokens, returns the token count or a negative error. */
+static yy_inline int jsmn_parse_all(const char *json, size_t size,
+                                    jsmntok_t *tokens, unsigned int num_tokens) {
+    jsmn_parser parser;
+    jsmn_init(&parser);
+    int num = jsmn_parse(&parser, json, size, tokens, num_tokens);
+    if (num <= 0) return -1;
+    /* jsmn accepts partial or multiple root values, only one is valid;
+       the end of a string token is its closing quote */
+    usize end = tokens ? (usize)tokens[0].end + (tokens[0].type == JSMN_STRING) : size;
+    if (end != size) {
+        for (usize i = end; i < size; i++) {
+            char c = json[i];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') return -1;
+        }
+    }
+    return num;
+}
+
+
+// -----------------------------------------------------------------------------
+// reader
+
+u64 reader_measure_jsmn(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        int num = jsmn_parse_all(json, size, NULL, 0);
+        jsmntok_t *tokens = num > 0 ? malloc((usize)num * sizeof(jsmntok_t)) : NULL;
+        if (tokens) num = jsmn_parse_all(json, size, tokens, (unsigned int)num);
+        benchmark_tick_end();
+        bool suc = tokens && num > 0;
+        free(tokens);
+        if (!suc) return 0;
+    }
+    
+    *valid = true;
+    return benchmark_tick_min();
+}
+
+u64 reader_measure_jsmn_fixed(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
+    benchmark_tick_init();
+    
+    // zero allocation while parsing, like a static buffer on embedded devices
+    usize max = jsmn_max_tokens(size);
+    if (max > UINT_MAX) return 0;
+    jsmntok_t *tokens = malloc(max * sizeof(jsmntok_t));
+    if (!tokens) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        int num = jsmn_parse_all(json, size, tokens, (unsigned int)max);
+        benchmark_tick_end();
+        if (num <= 0) {
+            free(tokens);
+            return 0;
+        }
+    }
+    
+    free(tokens);
+    *valid = true;
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// stats
+
+/* Count the tokens by type, a primitive is classified by its first byte.
+   Object keys are string tokens, so they are counted as strings. */
+static yy_inline void stats_tokens(const char *json, const jsmntok_t *tokens,
+                                   int num, stats_data *data) {
+    for (int i = 0; i < num; i++) {
+        const jsmntok_t *tok = tokens + i;
+        switch (tok->type) {
+            case JSMN_OBJECT:
+                data->num_object++;
+                break;
+            case JSMN_ARRAY:
+                data->num_array++;
+                break;
+            case JSMN_STRING:
+                data->num_string++;
+                break;
+            case JSMN_PRIMITIVE:
+                switch (json[tok->start]) {
+                    case 't': data->num_true++; break;
+                    case 'f': data->num_false++; break;
+                    case 'n': data->num_null++; break;
+                    default: data->num_number++; break;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+u64 stats_measure_jsmn(const char *json, size_t size, stats_data *data, int repeat) {
+    benchmark_tick_init();
+    
+    int num = jsmn_parse_all(json, size, NULL, 0);
+    jsmntok_t *tokens = num > 0 ? malloc((usize)num * sizeof(jsmntok_t)) : NULL;
+    if (!tokens) return 0;
+    num = jsmn_parse_all(json, size, tokens, (unsigned int)num);
+    
+    for (int i = 0; i < repeat && num > 0; i++) {
+        memset(data, 0, sizeof(stats_data));
+        benchmark_tick_begin();
+        stats_tokens(json, tokens, num, data);
+        benchmark_tick_end();
+    }
+    free(tokens);
+    
+    return num > 0 ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// sax
+
+u64 sax_measure_jsmn(const char *json, size_t size, stats_data *data, int repeat) {
+    benchmark_tick_init();
+    
+    // tokenize into the fixed arena and count the tokens in one pass
+    usize max = jsmn_max_tokens(size);
+    if (max > UINT_MAX) return 0;
+    jsmntok_t *tokens = malloc(max * sizeof(jsmntok_t));
+    if (!tokens) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        memset(data, 0, sizeof(stats_data));
+        benchmark_tick_begin();
+        int num = jsmn_parse_all(json, size, tokens, (unsigned int)max);
+        if (num > 0) stats_tokens(json, tokens, num, data);
+        benchmark_tick_end();
+        if (num <= 0) {
+            free(tokens);
+            return 0;
+        }
+    }
+    
+    free(tokens);
+    return benchmark_tick_min();
+}
@@ -0,0 +1,378 @@
+#include "benchmark.h"
+#include "json.h"
+
+/* The default depth (32) is too small for some of the test data. */
+#define JSON_C_MAX_DEPTH 1024
+
+/* Chunk size of the streaming reader, as the data may come from a socket. */
+#define JSON_C_STREAM_CHUNK 4096
+
+static json_tokener *json_c_tokener_new(void) {
+    json_tokener *tok = json_tokener_new_ex(JSON_C_MAX_DEPTH);
+    if (tok) json_tokener_set_flags(tok, JSON_TOKENER_STRICT | JSON_TOKENER_VALIDATE_UTF8);
+    return tok;
+}
+
+/*
+ Parse the input in chunks with the tokener. The null-terminator is fed as the
+ end of the input, otherwise a number at root is never completed. The JSON
+ `null` is returned as NULL, so the result is returned with `root`.
+ */
+static bool json_c_parse(json_tokener *tok, const char *json, size_t size,
+                         size_t chunk, json_object **root) {
+    size_t pos = 0, len = size + 1;
+    bool suc = false;
+    json_object *obj = NULL;
+    
+    json_tokener_reset(tok);
+    while (pos < len) {
+        size_t n = len - pos < chunk ? len - pos : chunk;
+        if (n > INT32_MAX) n = INT32_MAX;
+        obj = json_tokener_parse_ex(tok, json + pos, (int)n);
+        enum json_tokener_error err = json_tokener_get_error(tok);
+        if (err == json_tokener_success) {
+            pos += json_tokener_get_parse_end(tok);
+            suc = true;
+            break;
+        }
+        if (err != json_tokener_continue) return false;
+        pos += n;
+    }
+    if (!suc) return false;
+    
+    // only whitespace can follow the root value
+    for (; pos < size; pos++) {
+        char c = json[pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            json_object_put(obj);
+            return false;
+        }
+    }
+    *root = obj;
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------
+// reader
+
+u64 reader_measure_json_c(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
+    benchmark_tick_init();
+    
+    json_tokener *tok = json_c_tokener_new();
+    if (!tok) return 0;
+    for (int i = 0; i < repeat; i++) {
+        json_object *root = NULL;
+        benchmark_tick_begin();
+        bool suc = json_c_parse(tok, json, size, SIZE_MAX, &root);
+        benchmark_tick_end();
+        if (!suc) {
+            json_tokener_free(tok);
+            return 0;
+        }
+        json_object_put(root);
+    }
+    json_tokener_free(tok);
+    
+    *valid = true;
+    return benchmark_tick_min();
+}
+
+u64 reader_measure_json_c_stream(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
+    benchmark_tick_init();
+    
+    json_tokener *tok = json_c_tokener_new();
+    if (!tok) return 0;
+    for (int i = 0; i < repeat; i++) {
+        json_object *root = NULL;
+        benchmark_tick_begin();
+        bool suc = json_c_parse(tok, json, size, JSON_C_STREAM_CHUNK, &root);
+        benchmark_tick_end();
+        if (!suc) {
+            json_tokener_free(tok);
+            return 0;
+        }
+        json_object_put(root);
+    }
+    json_tokener_free(tok);
+    
+    *valid = true;
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// writer
+
+u64 writer_measure_json_c(const char *json, size_t size, size_t *out_size,
+                          bool *roundtrip, bool pretty, int repeat) {
+    benchmark_tick_init();
+    
+    json_tokener *tok = json_c_tokener_new();
+    json_object *root = NULL;
+    bool suc = tok && json_c_parse(tok, json, size, SIZE_MAX, &root);
+    if (tok) json_tokener_free(tok);
+    if (!suc) return 0;
+    
+    // the output buffer is owned by the object and reused by the next call
+    int flag = JSON_C_TO_STRING_NOSLASHESCAPE;
+    flag |= pretty ? JSON_C_TO_STRING_PRETTY : JSON_C_TO_STRING_PLAIN;
+    bool processed = false;
+    for (int i = 0; i < repeat; i++) {
+        size_t len = 0;
+        benchmark_tick_begin();
+        const char *str = json_object_to_json_string_length(root, flag, &len);
+        benchmark_tick_end();
+        if (!str) {
+            json_object_put(root);
+            return 0;
+        }
+        if (!processed) {
+            processed = true;
+            *out_size = len;
+            *roundtrip = (len == size && memcmp(json, str, size) == 0);
+        }
+    }
+    json_object_put(root);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// stats
+
+static yy_inline void stats_single(json_object *val, stats_data *data) {
+    switch (json_object_get_type(val)) {
+        case json_type_string:
+            data->num_string++;
+            break;
+        case json_type_int:
+        case json_type_double:
+            data->num_number++;
+            break;
+        case json_type_boolean:
+            if (json_object_get_boolean(val)) data->num_true++;
+            else data->num_false++;
+            break;
+        case json_type_null:
+            data->num_null++;
+            break;
+        default:
+            break;
+    }
+}
+
+static void stats_recursive(json_object *val, stats_data *data) {
+    if (json_object_is_type(val, json_type_array)) {
+        data->num_array++;
+        size_t len = json_object_array_length(val);
+        for (size_t i = 0; i < len; i++) {
+            json_object *tmp = json_object_array_get_idx(val, i);
+            if (json_object_is_type(tmp, json_type_array) ||
+                json_object_is_type(tmp, json_type_object)) stats_recursive(tmp, data);
+            else stats_single(tmp, data);
+        }
+    } else if (json_object_is_type(val, json_type_object)) {
+        data->num_object++;
+        json_object_object_foreach(val, k, v) {
+            (void)k;
+            data->num_string++;
+            if (json_object_is_type(v, json_type_array) ||
+                json_object_is_type(v, json_type_object)) stats_recursive(v, data);
+            else stats_single(v, data);
+        }
+    } else {
+        stats_single(val, data);
+    }
+}
+
+u64 stats_measure_json_c(const char *json, size_t size, stats_data *data, int repeat) {
+    benchmark_tick_init();
+    
+    json_tokener *tok = json_c_tokener_new();
+    json_object *root = NULL;
+    bool suc = tok && json_c_parse(tok, json, size, SIZE_MAX, &root);
+    if (tok) json_tokener_free(tok);
+    if (!suc) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        memset(data, 0, sizeof(stats_data));
+        benchmark_tick_begin();
+        stats_recursive(root, data);
+        benchmark_tick_end();
+    }
+    json_object_put(root);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// utf8
+
+u64 utf8_measure_json_c(const char *json, size_t size, bool validate, int repeat) {
+    benchmark_tick_init();
+    
+    json_tokener *tok = json_c_tokener_new();
+    if (!tok) return 0;
+    if (!validate) json_tokener_set_flags(tok, JSON_TOKENER_STRICT);
+    for (int i = 0; i < repeat; i++) {
+        json_object *root = NULL;
+        benchmark_tick_begin();
+        bool suc = json_c_parse(tok, json, size, SIZE_MAX, &root);
+        benchmark_tick_end();
+        if (!suc) {
+            json_tokener_free(tok);
+            return 0;
+        }
+        json_object_put(root);
+    }
+    json_tokener_free(tok);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// string
+
+u64 string_reader_measure_json_c(const char *json, size_t size, usize *len, int repeat) {
+    benchmark_tick_init();
+    
+    json_tokener *tok = json_c_tokener_new();
+    if (!tok) return 0;
+    for (int i = 0; i < repeat; i++) {
+        usize sum = 0;
+        json_object *root = NULL;
+        benchmark_tick_begin();
+        bool suc = json_c_parse(tok, json, size, SIZE_MAX, &root);
+        if (suc && json_object_is_type(root, json_type_array)) {
+            size_t num = json_object_array_length(root);
+            for (size_t n = 0; n < num; n++) {
+                sum += (usize)json_object_get_string_len(json_object_array_get_idx(root, n));
+            }
+        }
+        benchmark_tick_end();
+        if (!suc) {
+            json_tokener_free(tok);
+            return 0;
+        }
+        json_object_put(root);
+        *len = sum;
+    }
+    json_tokener_free(tok);
+    
+    return benchmark_tick_min();
+}
+
+u64 string_writer_measure_json_c(const char *json, size_t size, string_escape esc,
+                                 size_t *out_size, int repeat) {
+    // json-c escapes slashes by default, but never escapes non-ASCII
+    if (esc == STRING_ESCAPE_UNICODE) return 0;
+    
+    benchmark_tick_init();
+    
+    json_tokener *tok = json_c_tokener_new();
+    json_object *root = NULL;
+    bool suc = tok && json_c_parse(tok, json, size, SIZE_MAX, &root);
+    if (tok) json_tokener_free(tok);
+    if (!suc) return 0;
+    
+    int flag = JSON_C_TO_STRING_PLAIN;
+    if (esc == STRING_ESCAPE_DEFAULT) flag |= JSON_C_TO_STRING_NOSLASHESCAPE;
+    for (int i = 0; i < repeat; i++) {
+        size_t len = 0;
+        benchmark_tick_begin();
+        const char *str = json_object_to_json_string_length(root, flag, &len);
+        benchmark_tick_end();
+        if (!str) {
+            json_object_put(root);
+            return 0;
+        }
+        *out_size = len;
+    }
+    json_object_put(root);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// blob
+
+u64 blob_measure_json_c(const char *json, size_t size, bool insitu,
+                        usize *mem, int repeat) {
+    // the strings are always copied, the memory is not reported
+    if (insitu) return 0;
+    
+    bool valid;
+    u64 ticks = reader_measure_json_c(json, size, &valid, repeat);
+    *mem = 0;
+    return valid ? ticks : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// nested
+
+u64 nested_measure_json_c(const char *json, size_t size, nested_mode mode,
+                          usize *count, int repeat) {
+    // the input is never modified, the strings are copied into the objects
+    if (mode == NESTED_INSITU) return 0;
+    
+    benchmark_tick_init();
+    
+    json_tokener *tok = json_c_tokener_new();
+    json_tokener *inner_tok = json_c_tokener_new();
+    if (!tok || !inner_tok) {
+        if (tok) json_tokener_free(tok);
+        if (inner_tok) json_tokener_free(inner_tok);
+        return 0;
+    }
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        json_object *root = NULL;
+        benchmark_tick_begin();
+        bool suc = json_c_parse(tok, json, size, SIZE_MAX, &root) &&
+                   json_object_is_type(root, json_type_array);
+        size_t msg_num = suc ? json_object_array_length(root) : 0;
+        for (size_t m = 0; m < msg_num; m++) {
+            json_object *payload = NULL, *inner = NULL;
+            json_object *msg = json_object_array_get_idx(root, m);
+            if (!json_object_object_get_ex(msg, "payload", &payload) ||
+                !json_object_is_type(payload, json_type_string)) {
+                suc = false;
+                break;
+            }
+            // the strings are null-terminated, which json_c_parse() feeds
+            const char *str = json_object_get_string(payload);
+            size_t len = (size_t)json_object_get_string_len(payload);
+            char *tmp = NULL;
+            if (mode == NESTED_COPY) {
+                tmp = malloc(len + 1);
+                if (tmp) memcpy(tmp, str, len + 1);
+                str = tmp;
+            }
+            suc = str && json_c_parse(inner_tok, str, len, SIZE_MAX, &inner);
+            free(tmp);
+            if (!suc) break;
+            json_object_put(inner);
+            num++;
+        }
+        benchmark_tick_end();
+        json_object_put(root);
+        if (!suc) {
+            json_tokener_free(tok);
+            json_tokener_free(inner_tok);
+            return 0;
+        }
+        *count = num;
+    }
+    json_tokener_free(tok);
+    json_tokener_free(inner_tok);
+    
+    return benchmark_tick_min();
+}
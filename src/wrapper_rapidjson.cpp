@@ -3,8 +3,13 @@
 #include "rapidjson/document.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/reader.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/encodedstream.h"
 #include "rapidjson/writer.h"
 #include "rapidjson/prettywriter.h"
+#include "rapidjson/pointer.h"
+#include <memory>
+#include <vector>
 
 using namespace rapidjson;
 
@@ -40,7 +45,8 @@ extern "C" {
 // -----------------------------------------------------------------------------
 // reader
 
-u64 reader_measure_rapidjson(const char *json, size_t size, int repeat) {
+u64 reader_measure_rapidjson(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
     benchmark_tick_init();
     
     Document doc;
@@ -51,10 +57,12 @@ u64 reader_measure_rapidjson(const char *json, size_t size, int repeat) {
         if (doc.HasParseError()) return 0;
     }
     
+    *valid = true;
     return benchmark_tick_min();
 }
 
-u64 reader_measure_rapidjson_fast(const char *json, size_t size, int repeat) {
+u64 reader_measure_rapidjson_fast(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
     benchmark_tick_init();
     
     char *buf = (char *)malloc(size + 1);
@@ -69,6 +77,7 @@ u64 reader_measure_rapidjson_fast(const char *json, size_t size, int repeat) {
     }
     free((void *)buf);
     
+    *valid = true;
     return benchmark_tick_min();
 }
 
@@ -86,7 +95,7 @@ u64 writer_measure_rapidjson(const char *json, size_t size, size_t *out_size,
     if (pretty) {
         for (int i = 0; i < repeat; i++) {
             StringBuffer sb;
-            Writer<StringBuffer> writer(sb);
+            PrettyWriter<StringBuffer> writer(sb);
             benchmark_tick_begin();
             doc.Accept(writer);
             benchmark_tick_end();
@@ -99,11 +108,10 @@ u64 writer_measure_rapidjson(const char *json, size_t size, size_t *out_size,
     } else {
         for (int i = 0; i < repeat; i++) {
             StringBuffer sb;
-            PrettyWriter<StringBuffer> writer(sb);
+            Writer<StringBuffer> writer(sb);
             benchmark_tick_begin();
             doc.Accept(writer);
             benchmark_tick_end();
-            *out_size = sb.GetSize();
             if (!processed) {
                 processed = true;
                 *out_size = sb.GetSize();
@@ -185,5 +193,1268 @@ u64 stats_measure_rapidjson(const char *json, size_t size, stats_data *data, int
 }
 
 
+// -----------------------------------------------------------------------------
+// parallel writer
+
+struct parallel_writer_ctx {
+    const Value *root;
+    SizeType *firsts; // first child index of each segment, and the end
+    StringBuffer *bufs;
+    json_segment *segs;
+};
+
+static void parallel_writer_task(void *ctx_ptr, int idx) {
+    parallel_writer_ctx *ctx = (parallel_writer_ctx *)ctx_ptr;
+    const Value &root = *ctx->root;
+    StringBuffer &sb = ctx->bufs[idx];
+    sb.Clear();
+    Writer<StringBuffer> writer(sb);
+    if (root.IsObject()) {
+        writer.StartObject();
+        Value::ConstMemberIterator end = root.MemberBegin() + ctx->firsts[idx + 1];
+        for (Value::ConstMemberIterator m = root.MemberBegin() + ctx->firsts[idx]; m != end; ++m) {
+            writer.Key(m->name.GetString(), m->name.GetStringLength());
+            m->value.Accept(writer);
+        }
+        writer.EndObject(ctx->firsts[idx + 1] - ctx->firsts[idx]);
+    } else {
+        writer.StartArray();
+        Value::ConstValueIterator end = root.Begin() + ctx->firsts[idx + 1];
+        for (Value::ConstValueIterator v = root.Begin() + ctx->firsts[idx]; v != end; ++v) {
+            v->Accept(writer);
+        }
+        writer.EndArray(ctx->firsts[idx + 1] - ctx->firsts[idx]);
+    }
+    ctx->segs[idx].str = sb.GetString() + 1; // remove the brackets
+    ctx->segs[idx].len = sb.GetSize() - 2;
+}
+
+u64 parallel_writer_measure_rapidjson(const char *json, size_t size, size_t *out_size,
+                                      int thread_count, int repeat) {
+    benchmark_tick_init();
+    
+    Document doc;
+    doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+    if (doc.HasParseError() || !(doc.IsObject() || doc.IsArray())) return 0;
+    StringBuffer expect;
+    Writer<StringBuffer> expect_writer(expect);
+    doc.Accept(expect_writer);
+    
+    if (thread_count <= 1) {
+        for (int i = 0; i < repeat; i++) {
+            StringBuffer sb;
+            Writer<StringBuffer> writer(sb);
+            benchmark_tick_begin();
+            doc.Accept(writer);
+            benchmark_tick_end();
+            *out_size = sb.GetSize();
+        }
+        return benchmark_tick_min();
+    }
+    
+    // several segments per thread for load balancing
+    bool is_obj = doc.IsObject();
+    SizeType child_num = is_obj ? doc.MemberCount() : doc.Size();
+    int seg_num = thread_count * 4;
+    if ((SizeType)seg_num > child_num) seg_num = (int)child_num;
+    if (seg_num < 1) seg_num = 1;
+    yy_thread_pool *pool = yy_thread_pool_new(thread_count);
+    std::vector<SizeType> firsts(seg_num + 1);
+    std::vector<json_segment> segs(seg_num);
+    std::unique_ptr<StringBuffer[]> bufs(new StringBuffer[seg_num]);
+    parallel_writer_ctx ctx;
+    ctx.root = &doc;
+    ctx.firsts = firsts.data();
+    ctx.bufs = bufs.get();
+    ctx.segs = segs.data();
+    
+    bool suc = (pool != NULL);
+    for (int i = 0; i < repeat && suc; i++) {
+        benchmark_tick_begin();
+        for (int s = 0; s <= seg_num; s++) {
+            firsts[s] = (SizeType)((u64)child_num * (u64)s / (u64)seg_num);
+        }
+        yy_thread_pool_run(pool, parallel_writer_task, &ctx, seg_num);
+        char *str = (char *)malloc(json_segments_join_size(ctx.segs, seg_num));
+        if (str) *out_size = json_segments_join(ctx.segs, seg_num, is_obj, str, pool);
+        benchmark_tick_end();
+        
+        if (!str || !*out_size) {
+            suc = false;
+        } else if (i == 0) {
+            suc = (*out_size == expect.GetSize() &&
+                   memcmp(str, expect.GetString(), *out_size) == 0);
+        }
+        free(str);
+    }
+    
+    yy_thread_pool_free(pool);
+    
+    return suc ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// number reader
+
+u64 number_reader_measure_rapidjson(const number_data *data, f64 *vals,
+                                    bool single, int repeat) {
+    benchmark_tick_init();
+    
+    Document doc;
+    for (int i = 0; i < repeat; i++) {
+        if (single) {
+            benchmark_tick_begin();
+            for (usize n = 0; n < data->count; n++) {
+                doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(data->strs[n], data->lens[n]);
+                vals[n] = (!doc.HasParseError() && doc.IsNumber()) ? doc.GetDouble() : NAN;
+            }
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(data->array, data->array_size);
+            usize idx = 0;
+            if (!doc.HasParseError()) {
+                for (Value::ConstValueIterator v = doc.Begin(); v != doc.End(); ++v) {
+                    vals[idx++] = v->GetDouble();
+                }
+            }
+            benchmark_tick_end();
+            if (doc.HasParseError()) return 0;
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// number writer
+
+u64 number_writer_measure_rapidjson(const number_values *vals, char **out,
+                                    usize *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    // write with SAX writer directly, reals are formatted with Grisu2
+    StringBuffer sb;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        sb.Clear();
+        Writer<StringBuffer> writer(sb);
+        writer.StartArray();
+        if (vals->is_int) {
+            for (usize n = 0; n < vals->count; n++) writer.Int64(vals->ints[n]);
+        } else {
+            for (usize n = 0; n < vals->count; n++) writer.Double(vals->reals[n]);
+        }
+        writer.EndArray();
+        benchmark_tick_end();
+        if (!writer.IsComplete()) return 0;
+    }
+    
+    *out_size = sb.GetSize();
+    *out = (char *)malloc(*out_size + 1);
+    memcpy(*out, sb.GetString(), *out_size + 1);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// roundtrip
+
+u64 roundtrip_measure_rapidjson(const char *json, size_t size, size_t *out_size,
+                                bool *roundtrip, int repeat) {
+    benchmark_tick_init();
+    
+    *roundtrip = true;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        Document doc;
+        doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+        StringBuffer sb;
+        Writer<StringBuffer> writer(sb);
+        bool suc = !doc.HasParseError() && doc.Accept(writer);
+        benchmark_tick_end();
+        if (!suc) return 0;
+        *out_size = sb.GetSize();
+        if (*out_size != size || memcmp(json, sb.GetString(), size) != 0) *roundtrip = false;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// lookup
+
+static const Value *lookup_resolve(const Value *val, const lookup_target *target) {
+    for (usize d = 0; d < target->depth && val; d++) {
+        if (val->IsArray()) {
+            SizeType idx = (SizeType)strtoul(target->path[d], NULL, 10);
+            val = idx < val->Size() ? &(*val)[idx] : NULL;
+        } else if (val->IsObject()) {
+            Value::ConstMemberIterator it = val->FindMember(target->path[d]);
+            val = it != val->MemberEnd() ? &it->value : NULL;
+        } else {
+            val = NULL;
+        }
+    }
+    return val;
+}
+
+u64 lookup_measure_rapidjson(const char *json, size_t size,
+                             const lookup_target *targets, usize target_count,
+                             usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    Document doc;
+    doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+    if (doc.HasParseError()) return 0;
+    std::vector<const Value *> objs(target_count);
+    bool suc = true;
+    for (usize t = 0; t < target_count; t++) {
+        objs[t] = lookup_resolve(&doc, targets + t);
+        if (!objs[t] || !objs[t]->IsObject()) suc = false;
+    }
+    
+    for (int i = 0; i < repeat && suc; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize t = 0; t < target_count; t++) {
+            const lookup_target *target = targets + t;
+            const Value *obj = objs[t];
+            for (usize k = 0; k < target->key_count; k++) {
+                Value name(StringRef(target->keys[k], (SizeType)target->key_lens[k]));
+                num += obj->FindMember(name) != obj->MemberEnd();
+            }
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    return suc ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// pointer
+
+u64 pointer_measure_rapidjson(const char *json, size_t size, const pointer_data *data,
+                              bool walk_only, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    Document doc;
+    doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+    if (doc.HasParseError()) return 0;
+    
+    // walk only: the pointers are parsed into rapidjson's own tokens before meansure
+    std::vector<Pointer> ptrs;
+    if (walk_only) {
+        ptrs.reserve(data->count);
+        for (usize p = 0; p < data->count; p++) {
+            ptrs.emplace_back(data->ptrs[p], (size_t)data->lens[p]);
+        }
+    }
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        if (walk_only) {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                num += ptrs[p].Get(doc) != NULL;
+            }
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                Pointer ptr(data->ptrs[p], (size_t)data->lens[p]);
+                num += ptr.Get(doc) != NULL;
+            }
+            benchmark_tick_end();
+        }
+        *found = num;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// path
+
+static json_path_type path_get_type(json_path_val val) {
+    switch (((const Value *)val.ptr)->GetType()) {
+        case kNullType: return JSON_PATH_NULL;
+        case kFalseType:
+        case kTrueType: return JSON_PATH_BOOL;
+        case kNumberType: return JSON_PATH_NUM;
+        case kStringType: return JSON_PATH_STR;
+        case kArrayType: return JSON_PATH_ARR;
+        case kObjectType: return JSON_PATH_OBJ;
+        default: return JSON_PATH_NONE;
+    }
+}
+
+static bool path_get_bool(json_path_val val) {
+    return ((const Value *)val.ptr)->GetBool();
+}
+
+static f64 path_get_num(json_path_val val) {
+    return ((const Value *)val.ptr)->GetDouble();
+}
+
+static const char *path_get_str(json_path_val val, usize *len) {
+    const Value *v = (const Value *)val.ptr;
+    *len = v->GetStringLength();
+    return v->GetString();
+}
+
+static usize path_arr_size(json_path_val val) {
+    return ((const Value *)val.ptr)->Size();
+}
+
+static bool path_arr_get(json_path_val val, usize idx, json_path_val *out) {
+    const Value *v = (const Value *)val.ptr;
+    if (idx >= v->Size()) return false;
+    out->ptr = &(*v)[(SizeType)idx];
+    return true;
+}
+
+static bool path_obj_get(json_path_val val, const char *key, usize key_len,
+                         json_path_val *out) {
+    const Value *v = (const Value *)val.ptr;
+    Value name(StringRef(key, (SizeType)key_len));
+    Value::ConstMemberIterator it = v->FindMember(name);
+    if (it == v->MemberEnd()) return false;
+    out->ptr = &it->value;
+    return true;
+}
+
+static void path_foreach(json_path_val val, json_path_each_func func, void *ctx) {
+    const Value *v = (const Value *)val.ptr;
+    json_path_val sub = { NULL, 0 };
+    if (v->IsObject()) {
+        for (Value::ConstMemberIterator it = v->MemberBegin(); it != v->MemberEnd(); ++it) {
+            sub.ptr = &it->value;
+            func(ctx, it->name.GetString(), it->name.GetStringLength(), sub);
+        }
+    } else {
+        for (Value::ConstValueIterator it = v->Begin(); it != v->End(); ++it) {
+            sub.ptr = it;
+            func(ctx, NULL, 0, sub);
+        }
+    }
+}
+
+static const json_path_adapter path_adapter = {
+    path_get_type, path_get_bool, path_get_num, path_get_str,
+    path_arr_size, path_arr_get, path_obj_get, path_foreach
+};
+
+u64 path_measure_rapidjson(const char *json, size_t size, const json_path *path,
+                           bool with_parse, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    Document doc;
+    doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+    if (doc.HasParseError()) return 0;
+    json_path_val root = { &doc, 0 };
+    
+    for (int i = 0; i < repeat; i++) {
+        if (with_parse) {
+            benchmark_tick_begin();
+            Document tmp;
+            tmp.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+            root.ptr = &tmp;
+            if (!tmp.HasParseError()) *found = json_path_eval(path, &path_adapter, root);
+            benchmark_tick_end();
+            if (tmp.HasParseError()) return 0;
+        } else {
+            benchmark_tick_begin();
+            *found = json_path_eval(path, &path_adapter, root);
+            benchmark_tick_end();
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// index
+
+u64 index_measure_rapidjson(const char *json, size_t size, const usize *idxs,
+                            usize idx_count, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    Document doc;
+    doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+    if (doc.HasParseError() || !doc.IsArray()) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize n = 0; n < idx_count; n++) {
+            // read the element, an address of it does not touch the array
+            if (idxs[n] < doc.Size()) num += doc[(SizeType)idxs[n]].GetType() <= kNumberType;
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// mutate
+
+#define MUTATE_KEY_MAX 256
+
+static void mutate_val(Value &val, Document::AllocatorType &alc, usize *ops) {
+    if (val.IsObject()) {
+        usize n = val.MemberCount();
+        for (Value::MemberIterator it = val.MemberBegin(); it != val.MemberEnd(); ++it) {
+            mutate_val(it->value, alc, ops);
+        }
+        if (n >= 1) {
+            (val.MemberEnd() - 1)->value.SetInt64((int64_t)n);
+            (*ops)++;
+        }
+        if (n >= 3) {
+            val.EraseMember(val.MemberBegin() + (SizeType)(n / 2));
+            (*ops)++;
+        }
+        if (n >= 1) {
+            char buf[MUTATE_KEY_MAX];
+            Value &key = val.MemberBegin()->name;
+            usize len = key.GetStringLength();
+            if (len > MUTATE_KEY_MAX - 2) len = MUTATE_KEY_MAX - 2;
+            buf[0] = '_';
+            memcpy(buf + 1, key.GetString(), len);
+            key.SetString(buf, (SizeType)(len + 1), alc);
+            (*ops)++;
+        }
+        val.AddMember("_id", Value((int64_t)n), alc);
+        (*ops)++;
+    } else if (val.IsArray()) {
+        usize n = val.Size();
+        for (Value::ValueIterator it = val.Begin(); it != val.End(); ++it) {
+            mutate_val(*it, alc, ops);
+        }
+        val.PushBack(Value((int64_t)n), alc);
+        (*ops)++;
+        if (n >= 2) {
+            val.Erase(val.Begin() + (SizeType)(n / 4), val.Begin() + (SizeType)(n / 2));
+            // no insert API, append and move it to the front
+            val.PushBack(Value(StringRef("spliced")), alc);
+            for (SizeType i = val.Size() - 1; i > 0; i--) val[i].Swap(val[i - 1]);
+            (*ops)++;
+        }
+    } else if (val.IsDouble()) {
+        val.SetDouble(val.GetDouble() + 1);
+        (*ops)++;
+    } else if (val.IsInt64()) {
+        val.SetInt64(val.GetInt64() + 1);
+        (*ops)++;
+    } else if (val.IsUint64()) {
+        val.SetUint64(val.GetUint64() + 1);
+        (*ops)++;
+    } else if (val.IsBool()) {
+        val.SetBool(!val.GetBool());
+        (*ops)++;
+    }
+}
+
+u64 mutate_measure_rapidjson(const char *json, size_t size, bool write,
+                             usize *ops, size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        Document doc;
+        doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+        if (doc.HasParseError()) return 0;
+        
+        usize num = 0;
+        if (!write) {
+            benchmark_tick_begin();
+            mutate_val(doc, doc.GetAllocator(), &num);
+            benchmark_tick_end();
+        } else {
+            mutate_val(doc, doc.GetAllocator(), &num);
+            benchmark_tick_begin();
+            StringBuffer sb;
+            Writer<StringBuffer> writer(sb);
+            doc.Accept(writer);
+            *out_size = sb.GetSize();
+            benchmark_tick_end();
+        }
+        *ops = num;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+
+// -----------------------------------------------------------------------------
+// patch
+
+// A detached value is a heap allocated Value, its content is in the document's
+// memory pool, so only the shell is deleted on release.
+
+static json_path_type patch_get_type(void *val) {
+    json_path_val v = { val, 0 };
+    return path_get_type(v);
+}
+
+static bool patch_get_bool(void *val) {
+    return ((const Value *)val)->GetBool();
+}
+
+static f64 patch_get_num(void *val) {
+    return ((const Value *)val)->GetDouble();
+}
+
+static const char *patch_get_str(void *val, usize *len) {
+    const Value *v = (const Value *)val;
+    *len = v->GetStringLength();
+    return v->GetString();
+}
+
+static usize patch_size(void *ctn) {
+    const Value *v = (const Value *)ctn;
+    return v->IsObject() ? v->MemberCount() : v->Size();
+}
+
+static void *patch_arr_get(void *arr, usize idx) {
+    return &(*(Value *)arr)[(SizeType)idx];
+}
+
+static void *patch_obj_get(void *obj, const char *key, usize key_len) {
+    Value *v = (Value *)obj;
+    Value name(StringRef(key, (SizeType)key_len));
+    Value::MemberIterator it = v->FindMember(name);
+    return it == v->MemberEnd() ? NULL : &it->value;
+}
+
+static bool patch_obj_foreach(void *obj, json_patch_each_func func, void *each_ctx) {
+    Value *v = (Value *)obj;
+    for (Value::MemberIterator it = v->MemberBegin(); it != v->MemberEnd(); ++it) {
+        if (!func(each_ctx, it->name.GetString(), it->name.GetStringLength(), &it->value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *patch_dup(void *ctx, void *val) {
+    return new Value(*(const Value *)val, *(Document::AllocatorType *)ctx);
+}
+
+static void *patch_new_obj(void *ctx) {
+    return new Value(kObjectType);
+}
+
+static void patch_release(void *ctx, void *val) {
+    delete (Value *)val;
+}
+
+static bool patch_obj_put(void *ctx, void *obj, const char *key, usize key_len,
+                          void *val) {
+    Document::AllocatorType &alc = *(Document::AllocatorType *)ctx;
+    Value *v = (Value *)obj, *src = (Value *)val;
+    Value name(StringRef(key, (SizeType)key_len));
+    Value::MemberIterator it = v->FindMember(name);
+    if (it != v->MemberEnd()) {
+        it->value = *src;
+    } else {
+        Value dup(key, (SizeType)key_len, alc);
+        v->AddMember(dup, *src, alc);
+    }
+    delete src;
+    return true;
+}
+
+static void *patch_obj_remove(void *ctx, void *obj, const char *key, usize key_len) {
+    Value *v = (Value *)obj;
+    Value name(StringRef(key, (SizeType)key_len));
+    Value::MemberIterator it = v->FindMember(name);
+    if (it == v->MemberEnd()) return NULL;
+    Value *out = new Value();
+    *out = it->value;
+    v->EraseMember(it);
+    return out;
+}
+
+static bool patch_arr_insert(void *ctx, void *arr, usize idx, void *val) {
+    Value &v = *(Value *)arr;
+    Value *src = (Value *)val;
+    // no insert API, append and move it to the index
+    v.PushBack(*src, *(Document::AllocatorType *)ctx);
+    for (SizeType i = v.Size() - 1; i > (SizeType)idx; i--) v[i].Swap(v[i - 1]);
+    delete src;
+    return true;
+}
+
+static void *patch_arr_remove(void *ctx, void *arr, usize idx) {
+    Value *v = (Value *)arr;
+    Value *out = new Value();
+    *out = (*v)[(SizeType)idx];
+    v->Erase(v->Begin() + (SizeType)idx);
+    return out;
+}
+
+static const json_patch_adapter patch_adapter = {
+    NULL, patch_get_type, patch_get_bool, patch_get_num, patch_get_str,
+    patch_size, patch_arr_get, patch_obj_get, patch_obj_foreach,
+    patch_dup, patch_new_obj, patch_release,
+    patch_obj_put, patch_obj_remove, patch_arr_insert, patch_arr_remove
+};
+
+u64 patch_measure_rapidjson(const char *json, size_t size, const char *patch,
+                            size_t patch_size, bool merge, int repeat) {
+    benchmark_tick_init();
+    
+    Document doc, ops;
+    doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+    ops.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(patch, patch_size);
+    if (doc.HasParseError() || ops.HasParseError()) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        bool suc;
+        Document tmp;
+        json_patch_adapter adp = patch_adapter;
+        adp.ctx = &tmp.GetAllocator();
+        benchmark_tick_begin();
+        tmp.CopyFrom(doc, tmp.GetAllocator());
+        if (merge) suc = json_merge_patch_apply(&adp, &tmp, &ops);
+        else suc = json_patch_apply(&adp, &tmp, &ops);
+        benchmark_tick_end();
+        if (!suc) return 0;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+
+// -----------------------------------------------------------------------------
+// build
+
+typedef Document::AllocatorType build_alc;
+
+static inline Value build_str_val(build_str str, bool copy, build_alc &alc) {
+    if (!str.str) return Value();
+    if (copy) return Value(str.str, (SizeType)str.len, alc);
+    return Value(StringRef(str.str, (SizeType)str.len));
+}
+
+static inline void build_add_str(Value &obj, const char *key, build_str str, bool copy,
+                                 build_alc &alc) {
+    Value val = build_str_val(str, copy, alc);
+    obj.AddMember(StringRef(key), val, alc);
+}
+
+static inline void build_add_id(Value &obj, const char *key, u64 id, build_alc &alc) {
+    if (id) obj.AddMember(StringRef(key), Value((uint64_t)id), alc);
+    else obj.AddMember(StringRef(key), Value(), alc);
+}
+
+static inline void build_add_uints(Value &obj, const char *key, const u64 *vals, usize count,
+                                   build_alc &alc) {
+    Value arr(kArrayType);
+    arr.Reserve((SizeType)count, alc);
+    for (usize i = 0; i < count; i++) arr.PushBack(Value((uint64_t)vals[i]), alc);
+    obj.AddMember(StringRef(key), arr, alc);
+}
+
+static void build_twitter_doc(Value &root, const build_twitter *tw, bool copy, build_alc &alc) {
+    root.SetObject();
+    Value statuses(kArrayType);
+    statuses.Reserve((SizeType)tw->status_count, alc);
+    for (usize i = 0; i < tw->status_count; i++) {
+        const build_status *s = tw->statuses + i;
+        const build_user *u = &s->user;
+        Value st(kObjectType);
+        build_add_str(st, "created_at", s->created_at, copy, alc);
+        st.AddMember("id", Value((uint64_t)s->id), alc);
+        build_add_str(st, "id_str", s->id_str, copy, alc);
+        build_add_str(st, "text", s->text, copy, alc);
+        build_add_str(st, "source", s->source, copy, alc);
+        st.AddMember("truncated", Value(s->truncated), alc);
+        build_add_id(st, "in_reply_to_status_id", s->in_reply_to_status_id, alc);
+        build_add_str(st, "in_reply_to_status_id_str", s->in_reply_to_status_id_str, copy, alc);
+        build_add_id(st, "in_reply_to_user_id", s->in_reply_to_user_id, alc);
+        build_add_str(st, "in_reply_to_user_id_str", s->in_reply_to_user_id_str, copy, alc);
+        build_add_str(st, "in_reply_to_screen_name", s->in_reply_to_screen_name, copy, alc);
+        
+        Value user(kObjectType);
+        user.AddMember("id", Value((uint64_t)u->id), alc);
+        build_add_str(user, "id_str", u->id_str, copy, alc);
+        build_add_str(user, "name", u->name, copy, alc);
+        build_add_str(user, "screen_name", u->screen_name, copy, alc);
+        build_add_str(user, "location", u->location, copy, alc);
+        build_add_str(user, "description", u->description, copy, alc);
+        user.AddMember("protected", Value(u->is_protected), alc);
+        user.AddMember("followers_count", Value((uint64_t)u->followers_count), alc);
+        user.AddMember("friends_count", Value((uint64_t)u->friends_count), alc);
+        user.AddMember("listed_count", Value((uint64_t)u->listed_count), alc);
+        build_add_str(user, "created_at", u->created_at, copy, alc);
+        user.AddMember("favourites_count", Value((uint64_t)u->favourites_count), alc);
+        user.AddMember("verified", Value(u->verified), alc);
+        user.AddMember("statuses_count", Value((uint64_t)u->statuses_count), alc);
+        build_add_str(user, "lang", u->lang, copy, alc);
+        build_add_str(user, "profile_image_url", u->profile_image_url, copy, alc);
+        st.AddMember("user", user, alc);
+        
+        st.AddMember("retweet_count", Value((uint64_t)s->retweet_count), alc);
+        st.AddMember("favorite_count", Value((uint64_t)s->favorite_count), alc);
+        
+        Value ent(kObjectType), tags(kArrayType), mens(kArrayType);
+        for (usize t = 0; t < s->hashtag_count; t++) {
+            Value tag(kObjectType);
+            build_add_str(tag, "text", s->hashtags[t].text, copy, alc);
+            build_add_uints(tag, "indices", s->hashtags[t].indices, 2, alc);
+            tags.PushBack(tag, alc);
+        }
+        for (usize m = 0; m < s->mention_count; m++) {
+            const build_mention *mention = s->mentions + m;
+            Value men(kObjectType);
+            build_add_str(men, "screen_name", mention->screen_name, copy, alc);
+            build_add_str(men, "name", mention->name, copy, alc);
+            men.AddMember("id", Value((uint64_t)mention->id), alc);
+            build_add_str(men, "id_str", mention->id_str, copy, alc);
+            build_add_uints(men, "indices", mention->indices, 2, alc);
+            mens.PushBack(men, alc);
+        }
+        ent.AddMember("hashtags", tags, alc);
+        ent.AddMember("user_mentions", mens, alc);
+        st.AddMember("entities", ent, alc);
+        
+        st.AddMember("favorited", Value(s->favorited), alc);
+        st.AddMember("retweeted", Value(s->retweeted), alc);
+        build_add_str(st, "lang", s->lang, copy, alc);
+        statuses.PushBack(st, alc);
+    }
+    root.AddMember("statuses", statuses, alc);
+    
+    Value meta(kObjectType);
+    meta.AddMember("completed_in", Value(tw->completed_in), alc);
+    meta.AddMember("max_id", Value((uint64_t)tw->max_id), alc);
+    build_add_str(meta, "max_id_str", tw->max_id_str, copy, alc);
+    build_add_str(meta, "next_results", tw->next_results, copy, alc);
+    build_add_str(meta, "query", tw->query, copy, alc);
+    build_add_str(meta, "refresh_url", tw->refresh_url, copy, alc);
+    meta.AddMember("count", Value((uint64_t)tw->count), alc);
+    meta.AddMember("since_id", Value((uint64_t)tw->since_id), alc);
+    build_add_str(meta, "since_id_str", tw->since_id_str, copy, alc);
+    root.AddMember("search_metadata", meta, alc);
+}
+
+static void build_citm_doc(Value &root, const build_citm *citm, bool copy, build_alc &alc) {
+    root.SetObject();
+    Value events(kObjectType);
+    for (usize i = 0; i < citm->event_count; i++) {
+        const build_event *e = citm->events + i;
+        Value evt(kObjectType);
+        evt.AddMember("description", Value(), alc);
+        evt.AddMember("id", Value((uint64_t)e->id), alc);
+        build_add_str(evt, "logo", e->logo, copy, alc);
+        build_add_str(evt, "name", e->name, copy, alc);
+        build_add_uints(evt, "subTopicIds", e->sub_topic_ids, e->sub_topic_count, alc);
+        evt.AddMember("subjectCode", Value(), alc);
+        evt.AddMember("subtitle", Value(), alc);
+        build_add_uints(evt, "topicIds", e->topic_ids, e->topic_count, alc);
+        Value key = build_str_val(e->key, copy, alc);
+        events.AddMember(key, evt, alc);
+    }
+    root.AddMember("events", events, alc);
+    
+    Value perfs(kArrayType);
+    perfs.Reserve((SizeType)citm->performance_count, alc);
+    for (usize i = 0; i < citm->performance_count; i++) {
+        const build_performance *p = citm->performances + i;
+        Value perf(kObjectType), prices(kArrayType), cats(kArrayType);
+        perf.AddMember("eventId", Value((uint64_t)p->event_id), alc);
+        perf.AddMember("id", Value((uint64_t)p->id), alc);
+        build_add_str(perf, "logo", p->logo, copy, alc);
+        perf.AddMember("name", Value(), alc);
+        for (usize n = 0; n < p->price_count; n++) {
+            Value price(kObjectType);
+            price.AddMember("amount", Value((uint64_t)p->prices[n].amount), alc);
+            price.AddMember("audienceSubCategoryId",
+                            Value((uint64_t)p->prices[n].audience_sub_category_id), alc);
+            price.AddMember("seatCategoryId", Value((uint64_t)p->prices[n].seat_category_id), alc);
+            prices.PushBack(price, alc);
+        }
+        perf.AddMember("prices", prices, alc);
+        for (usize n = 0; n < p->seat_category_count; n++) {
+            const build_seat_category *c = p->seat_categories + n;
+            Value cat(kObjectType), areas(kArrayType);
+            for (usize a = 0; a < c->area_count; a++) {
+                Value area(kObjectType);
+                area.AddMember("areaId", Value((uint64_t)c->area_ids[a]), alc);
+                area.AddMember("blockIds", Value(kArrayType), alc);
+                areas.PushBack(area, alc);
+            }
+            cat.AddMember("areas", areas, alc);
+            cat.AddMember("seatCategoryId", Value((uint64_t)c->seat_category_id), alc);
+            cats.PushBack(cat, alc);
+        }
+        perf.AddMember("seatCategories", cats, alc);
+        perf.AddMember("seatMapImage", Value(), alc);
+        perf.AddMember("start", Value((uint64_t)p->start), alc);
+        build_add_str(perf, "venueCode", p->venue_code, copy, alc);
+        perfs.PushBack(perf, alc);
+    }
+    root.AddMember("performances", perfs, alc);
+    
+    for (usize m = 0; m < citm->map_count; m++) {
+        const build_name_map *map = citm->maps + m;
+        Value obj(kObjectType);
+        for (usize n = 0; n < map->count; n++) {
+            Value key = build_str_val(map->names[n].key, copy, alc);
+            Value name = build_str_val(map->names[n].name, copy, alc);
+            obj.AddMember(key, name, alc);
+        }
+        root.AddMember(StringRef(map->name.str, (SizeType)map->name.len), obj, alc);
+    }
+}
+
+u64 build_measure_rapidjson(const build_data *data, bool copy, bool write,
+                            size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        Document doc;
+        benchmark_tick_begin();
+        if (data->twitter) build_twitter_doc(doc, data->twitter, copy, doc.GetAllocator());
+        else build_citm_doc(doc, data->citm, copy, doc.GetAllocator());
+        if (write) {
+            StringBuffer sb;
+            Writer<StringBuffer> writer(sb);
+            doc.Accept(writer);
+            *out_size = sb.GetSize();
+        }
+        benchmark_tick_end();
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+
+// -----------------------------------------------------------------------------
+// stream
+
+typedef Writer<StringBuffer> stream_writer;
+
+#define stream_key(w, key) (w).Key(key, (SizeType)(sizeof(key) - 1))
+
+static inline void stream_str(stream_writer &w, build_str str) {
+    if (str.str) w.String(str.str, (SizeType)str.len);
+    else w.Null();
+}
+
+static inline void stream_id(stream_writer &w, u64 id) {
+    if (id) w.Uint64(id);
+    else w.Null();
+}
+
+static inline void stream_uints(stream_writer &w, const u64 *vals, usize count) {
+    w.StartArray();
+    for (usize i = 0; i < count; i++) w.Uint64(vals[i]);
+    w.EndArray();
+}
+
+static void stream_twitter(stream_writer &w, const build_twitter *tw) {
+    w.StartObject();
+    stream_key(w, "statuses");
+    w.StartArray();
+    for (usize i = 0; i < tw->status_count; i++) {
+        const build_status *s = tw->statuses + i;
+        const build_user *u = &s->user;
+        w.StartObject();
+        stream_key(w, "created_at"); stream_str(w, s->created_at);
+        stream_key(w, "id"); w.Uint64(s->id);
+        stream_key(w, "id_str"); stream_str(w, s->id_str);
+        stream_key(w, "text"); stream_str(w, s->text);
+        stream_key(w, "source"); stream_str(w, s->source);
+        stream_key(w, "truncated"); w.Bool(s->truncated);
+        stream_key(w, "in_reply_to_status_id"); stream_id(w, s->in_reply_to_status_id);
+        stream_key(w, "in_reply_to_status_id_str"); stream_str(w, s->in_reply_to_status_id_str);
+        stream_key(w, "in_reply_to_user_id"); stream_id(w, s->in_reply_to_user_id);
+        stream_key(w, "in_reply_to_user_id_str"); stream_str(w, s->in_reply_to_user_id_str);
+        stream_key(w, "in_reply_to_screen_name"); stream_str(w, s->in_reply_to_screen_name);
+        
+        stream_key(w, "user");
+        w.StartObject();
+        stream_key(w, "id"); w.Uint64(u->id);
+        stream_key(w, "id_str"); stream_str(w, u->id_str);
+        stream_key(w, "name"); stream_str(w, u->name);
+        stream_key(w, "screen_name"); stream_str(w, u->screen_name);
+        stream_key(w, "location"); stream_str(w, u->location);
+        stream_key(w, "description"); stream_str(w, u->description);
+        stream_key(w, "protected"); w.Bool(u->is_protected);
+        stream_key(w, "followers_count"); w.Uint64(u->followers_count);
+        stream_key(w, "friends_count"); w.Uint64(u->friends_count);
+        stream_key(w, "listed_count"); w.Uint64(u->listed_count);
+        stream_key(w, "created_at"); stream_str(w, u->created_at);
+        stream_key(w, "favourites_count"); w.Uint64(u->favourites_count);
+        stream_key(w, "verified"); w.Bool(u->verified);
+        stream_key(w, "statuses_count"); w.Uint64(u->statuses_count);
+        stream_key(w, "lang"); stream_str(w, u->lang);
+        stream_key(w, "profile_image_url"); stream_str(w, u->profile_image_url);
+        w.EndObject();
+        
+        stream_key(w, "retweet_count"); w.Uint64(s->retweet_count);
+        stream_key(w, "favorite_count"); w.Uint64(s->favorite_count);
+        
+        stream_key(w, "entities");
+        w.StartObject();
+        stream_key(w, "hashtags");
+        w.StartArray();
+        for (usize t = 0; t < s->hashtag_count; t++) {
+            w.StartObject();
+            stream_key(w, "text"); stream_str(w, s->hashtags[t].text);
+            stream_key(w, "indices"); stream_uints(w, s->hashtags[t].indices, 2);
+            w.EndObject();
+        }
+        w.EndArray();
+        stream_key(w, "user_mentions");
+        w.StartArray();
+        for (usize m = 0; m < s->mention_count; m++) {
+            const build_mention *men = s->mentions + m;
+            w.StartObject();
+            stream_key(w, "screen_name"); stream_str(w, men->screen_name);
+            stream_key(w, "name"); stream_str(w, men->name);
+            stream_key(w, "id"); w.Uint64(men->id);
+            stream_key(w, "id_str"); stream_str(w, men->id_str);
+            stream_key(w, "indices"); stream_uints(w, men->indices, 2);
+            w.EndObject();
+        }
+        w.EndArray();
+        w.EndObject();
+        
+        stream_key(w, "favorited"); w.Bool(s->favorited);
+        stream_key(w, "retweeted"); w.Bool(s->retweeted);
+        stream_key(w, "lang"); stream_str(w, s->lang);
+        w.EndObject();
+    }
+    w.EndArray();
+    
+    stream_key(w, "search_metadata");
+    w.StartObject();
+    stream_key(w, "completed_in"); w.Double(tw->completed_in);
+    stream_key(w, "max_id"); w.Uint64(tw->max_id);
+    stream_key(w, "max_id_str"); stream_str(w, tw->max_id_str);
+    stream_key(w, "next_results"); stream_str(w, tw->next_results);
+    stream_key(w, "query"); stream_str(w, tw->query);
+    stream_key(w, "refresh_url"); stream_str(w, tw->refresh_url);
+    stream_key(w, "count"); w.Uint64(tw->count);
+    stream_key(w, "since_id"); w.Uint64(tw->since_id);
+    stream_key(w, "since_id_str"); stream_str(w, tw->since_id_str);
+    w.EndObject();
+    w.EndObject();
+}
+
+static void stream_citm(stream_writer &w, const build_citm *citm) {
+    w.StartObject();
+    stream_key(w, "events");
+    w.StartObject();
+    for (usize i = 0; i < citm->event_count; i++) {
+        const build_event *e = citm->events + i;
+        w.Key(e->key.str, (SizeType)e->key.len);
+        w.StartObject();
+        stream_key(w, "description"); w.Null();
+        stream_key(w, "id"); w.Uint64(e->id);
+        stream_key(w, "logo"); stream_str(w, e->logo);
+        stream_key(w, "name"); stream_str(w, e->name);
+        stream_key(w, "subTopicIds"); stream_uints(w, e->sub_topic_ids, e->sub_topic_count);
+        stream_key(w, "subjectCode"); w.Null();
+        stream_key(w, "subtitle"); w.Null();
+        stream_key(w, "topicIds"); stream_uints(w, e->topic_ids, e->topic_count);
+        w.EndObject();
+    }
+    w.EndObject();
+    
+    stream_key(w, "performances");
+    w.StartArray();
+    for (usize i = 0; i < citm->performance_count; i++) {
+        const build_performance *p = citm->performances + i;
+        w.StartObject();
+        stream_key(w, "eventId"); w.Uint64(p->event_id);
+        stream_key(w, "id"); w.Uint64(p->id);
+        stream_key(w, "logo"); stream_str(w, p->logo);
+        stream_key(w, "name"); w.Null();
+        stream_key(w, "prices");
+        w.StartArray();
+        for (usize n = 0; n < p->price_count; n++) {
+            w.StartObject();
+            stream_key(w, "amount"); w.Uint64(p->prices[n].amount);
+            stream_key(w, "audienceSubCategoryId"); w.Uint64(p->prices[n].audience_sub_category_id);
+            stream_key(w, "seatCategoryId"); w.Uint64(p->prices[n].seat_category_id);
+            w.EndObject();
+        }
+        w.EndArray();
+        stream_key(w, "seatCategories");
+        w.StartArray();
+        for (usize n = 0; n < p->seat_category_count; n++) {
+            const build_seat_category *c = p->seat_categories + n;
+            w.StartObject();
+            stream_key(w, "areas");
+            w.StartArray();
+            for (usize a = 0; a < c->area_count; a++) {
+                w.StartObject();
+                stream_key(w, "areaId"); w.Uint64(c->area_ids[a]);
+                stream_key(w, "blockIds"); w.StartArray(); w.EndArray();
+                w.EndObject();
+            }
+            w.EndArray();
+            stream_key(w, "seatCategoryId"); w.Uint64(c->seat_category_id);
+            w.EndObject();
+        }
+        w.EndArray();
+        stream_key(w, "seatMapImage"); w.Null();
+        stream_key(w, "start"); w.Uint64(p->start);
+        stream_key(w, "venueCode"); stream_str(w, p->venue_code);
+        w.EndObject();
+    }
+    w.EndArray();
+    
+    for (usize m = 0; m < citm->map_count; m++) {
+        const build_name_map *map = citm->maps + m;
+        w.Key(map->name.str, (SizeType)map->name.len);
+        w.StartObject();
+        for (usize n = 0; n < map->count; n++) {
+            w.Key(map->names[n].key.str, (SizeType)map->names[n].key.len);
+            stream_str(w, map->names[n].name);
+        }
+        w.EndObject();
+    }
+    w.EndObject();
+}
+
+u64 stream_measure_rapidjson(const build_data *data, char **out,
+                             size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        StringBuffer sb;
+        stream_writer writer(sb);
+        if (data->twitter) stream_twitter(writer, data->twitter);
+        else stream_citm(writer, data->citm);
+        benchmark_tick_end();
+        if (!writer.IsComplete()) return 0;
+        if (i + 1 == repeat) {
+            *out_size = sb.GetSize();
+            *out = (char *)malloc(sb.GetSize() + 1);
+            memcpy(*out, sb.GetString(), sb.GetSize() + 1);
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// sax
+
+u64 sax_measure_rapidjson(const char *json, size_t size, stats_data *data, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        memset(data, 0, sizeof(stats_data));
+        StatHandler<> handler(*data);
+        Reader reader;
+        MemoryStream ms(json, size);
+        EncodedInputStream<UTF8<>, MemoryStream> is(ms);
+        benchmark_tick_begin();
+        ParseResult res = reader.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(is, handler);
+        benchmark_tick_end();
+        if (!res) return 0;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// utf8
+
+u64 utf8_measure_rapidjson(const char *json, size_t size, bool validate, int repeat) {
+    benchmark_tick_init();
+    
+    Document doc;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        if (validate) doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+        else doc.Parse<kParseFullPrecisionFlag>(json, size);
+        benchmark_tick_end();
+        if (doc.HasParseError()) return 0;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// string
+
+u64 string_reader_measure_rapidjson(const char *json, size_t size, usize *len, int repeat) {
+    benchmark_tick_init();
+    
+    Document doc;
+    for (int i = 0; i < repeat; i++) {
+        usize sum = 0;
+        benchmark_tick_begin();
+        doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+        if (!doc.HasParseError() && doc.IsArray()) {
+            for (auto &val : doc.GetArray()) sum += val.GetStringLength();
+        }
+        benchmark_tick_end();
+        if (doc.HasParseError()) return 0;
+        *len = sum;
+    }
+    
+    return benchmark_tick_min();
+}
+
+u64 string_writer_measure_rapidjson(const char *json, size_t size, string_escape esc,
+                                    size_t *out_size, int repeat) {
+    // rapidjson never escapes slashes
+    if (esc == STRING_ESCAPE_SLASHES) return 0;
+    
+    benchmark_tick_init();
+    
+    Document doc;
+    doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+    if (doc.HasParseError()) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        StringBuffer sb;
+        if (esc == STRING_ESCAPE_UNICODE) {
+            // ASCII target encoding writes non-ASCII as \uXXXX
+            Writer<StringBuffer, UTF8<>, ASCII<>> writer(sb);
+            benchmark_tick_begin();
+            doc.Accept(writer);
+            benchmark_tick_end();
+        } else {
+            Writer<StringBuffer> writer(sb);
+            benchmark_tick_begin();
+            doc.Accept(writer);
+            benchmark_tick_end();
+        }
+        *out_size = sb.GetSize();
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// blob
+
+u64 blob_measure_rapidjson(const char *json, size_t size, bool insitu,
+                           usize *mem, int repeat) {
+    benchmark_tick_init();
+    
+    char *buf = insitu ? (char *)malloc(size + 1) : NULL;
+    if (insitu && !buf) return 0;
+    for (int i = 0; i < repeat; i++) {
+        // a new document each loop, the pool allocator never shrinks
+        Document doc;
+        if (insitu) {
+            memcpy((void *)buf, (void *)json, size);
+            buf[size] = '\0';
+            benchmark_tick_begin();
+            doc.ParseInsitu<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(buf);
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+            benchmark_tick_end();
+        }
+        if (doc.HasParseError()) {
+            free((void *)buf);
+            return 0;
+        }
+        *mem = doc.GetAllocator().Size();
+    }
+    free((void *)buf);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// nested
+
+u64 nested_measure_rapidjson(const char *json, size_t size, nested_mode mode,
+                             usize *count, int repeat) {
+    benchmark_tick_init();
+    
+    bool insitu = (mode == NESTED_INSITU);
+    char *buf = insitu ? (char *)malloc(size + 1) : NULL;
+    if (insitu && !buf) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        Document doc;
+        if (insitu) {
+            memcpy((void *)buf, (void *)json, size);
+            buf[size] = '\0';
+        }
+        usize num = 0;
+        bool suc = true;
+        benchmark_tick_begin();
+        if (insitu) doc.ParseInsitu<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(buf);
+        else doc.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(json, size);
+        if (doc.HasParseError() || !doc.IsArray()) suc = false;
+        for (SizeType m = 0; suc && m < doc.Size(); m++) {
+            const Value &msg = doc[m];
+            Value::ConstMemberIterator it;
+            if (!msg.IsObject() || (it = msg.FindMember("payload")) == msg.MemberEnd() ||
+                !it->value.IsString()) {
+                suc = false;
+                break;
+            }
+            const char *str = it->value.GetString();
+            usize len = it->value.GetStringLength();
+            Document inner;
+            if (mode == NESTED_COPY) {
+                char *tmp = (char *)malloc(len + 1);
+                if (!tmp) {
+                    suc = false;
+                    break;
+                }
+                memcpy((void *)tmp, (const void *)str, len + 1);
+                inner.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(tmp, len);
+                free((void *)tmp);
+            } else if (mode == NESTED_ZERO_COPY) {
+                inner.Parse<kParseValidateEncodingFlag | kParseFullPrecisionFlag>(str, len);
+            } else {
+                // the in-situ strings of the outer doc are null-terminated in the buffer
+                inner.ParseInsitu<kParseValidateEncodingFlag | kParseFullPrecisionFlag>((char *)str);
+            }
+            if (inner.HasParseError()) {
+                suc = false;
+                break;
+            }
+            num++;
+        }
+        benchmark_tick_end();
+        if (!suc) {
+            free((void *)buf);
+            return 0;
+        }
+        *count = num;
+    }
+    free((void *)buf);
+    
+    return benchmark_tick_min();
+}
+
 
 }
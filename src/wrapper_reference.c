@@ -0,0 +1,568 @@
+#include "benchmark.h"
+#include "david_gay_dtoa.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define ROOFLINE_HAS_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#   include <arm_neon.h>
+#   define ROOFLINE_HAS_NEON 1
+#endif
+
+/*
+ Reference implementations which are not JSON libraries,
+ used as baselines for the focused benchmarks.
+ */
+
+
+// -----------------------------------------------------------------------------
+// number reader (no document, same for single value and array)
+
+u64 number_reader_measure_strtod_gay(const number_data *data, f64 *vals,
+                                     bool single, int repeat) {
+    (void)single;
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        for (usize n = 0; n < data->count; n++) {
+            vals[n] = strtod_gay(data->strs[n], NULL);
+        }
+        benchmark_tick_end();
+    }
+    
+    return benchmark_tick_min();
+}
+
+u64 number_reader_measure_strtod(const number_data *data, f64 *vals,
+                                 bool single, int repeat) {
+    (void)single;
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        for (usize n = 0; n < data->count; n++) {
+            vals[n] = strtod(data->strs[n], NULL);
+        }
+        benchmark_tick_end();
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// number writer (write to a preallocated buffer)
+
+#define NUMBER_WRITER_MAX_LEN 40
+
+u64 number_writer_measure_dtoa_gay(const number_values *vals, char **out,
+                                   usize *out_size, int repeat) {
+    if (vals->is_int) return 0;
+    benchmark_tick_init();
+    
+    char *str = malloc(vals->count * NUMBER_WRITER_MAX_LEN + 3);
+    char *cur = str;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        cur = str;
+        *cur++ = '[';
+        for (usize n = 0; n < vals->count; n++) {
+            if (n) *cur++ = ',';
+            f64 val = vals->reals[n];
+            if (val == 0 && signbit(val)) *cur++ = '-'; // dtoa_gay() drops the sign of -0.0
+            cur = dtoa_gay(val, cur);
+        }
+        *cur++ = ']';
+        *cur = '\0';
+        benchmark_tick_end();
+    }
+    
+    *out = str;
+    *out_size = (usize)(cur - str);
+    return benchmark_tick_min();
+}
+
+u64 number_writer_measure_sprintf(const number_values *vals, char **out,
+                                  usize *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    char *str = malloc(vals->count * NUMBER_WRITER_MAX_LEN + 3);
+    char *cur = str;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        cur = str;
+        *cur++ = '[';
+        for (usize n = 0; n < vals->count; n++) {
+            if (n) *cur++ = ',';
+            if (vals->is_int) cur += sprintf(cur, "%lld", (long long)vals->ints[n]);
+            else cur += sprintf(cur, "%.17g", vals->reals[n]);
+        }
+        *cur++ = ']';
+        *cur = '\0';
+        benchmark_tick_end();
+    }
+    
+    *out = str;
+    *out_size = (usize)(cur - str);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// stream (hand-rolled emitter, writes literal keys and punctuation directly)
+
+#define EMITTER_INIT_CAP (64 * 1024)
+
+typedef struct {
+    char *hdr;
+    char *cur;
+    char *end;
+    bool failed; /* allocation failed, the following writes are dropped */
+} emitter;
+
+static bool emit_grow(emitter *e, usize len) {
+    if (e->failed) return false;
+    usize used = (usize)(e->cur - e->hdr);
+    usize cap = (usize)(e->end - e->hdr);
+    while (cap - used < len) cap *= 2;
+    char *hdr = realloc(e->hdr, cap);
+    if (!hdr) {
+        e->failed = true;
+        return false;
+    }
+    e->hdr = hdr;
+    e->cur = hdr + used;
+    e->end = hdr + cap;
+    return true;
+}
+
+static yy_inline bool emit_reserve(emitter *e, usize len) {
+    if ((usize)(e->end - e->cur) < len) return emit_grow(e, len);
+    return true;
+}
+
+static yy_inline void emit_raw(emitter *e, const char *str, usize len) {
+    if (!emit_reserve(e, len)) return;
+    memcpy(e->cur, str, len);
+    e->cur += len;
+}
+
+#define emit_lit(e, lit) emit_raw(e, lit, sizeof(lit) - 1)
+
+static yy_inline void emit_char(emitter *e, char c) {
+    if (!emit_reserve(e, 1)) return;
+    *e->cur++ = c;
+}
+
+static yy_inline void emit_bool(emitter *e, bool b) {
+    if (b) emit_lit(e, "true");
+    else emit_lit(e, "false");
+}
+
+static yy_inline void emit_u64(emitter *e, u64 val) {
+    char buf[20], *end = buf + sizeof(buf), *cur = end;
+    do {
+        *--cur = (char)('0' + val % 10);
+        val /= 10;
+    } while (val);
+    emit_raw(e, cur, (usize)(end - cur));
+}
+
+static yy_inline void emit_id(emitter *e, u64 id) {
+    if (id) emit_u64(e, id);
+    else emit_lit(e, "null");
+}
+
+/* Shortest representation which reads back to the same value. */
+static void emit_f64(emitter *e, f64 val) {
+    char buf[40];
+    int len = 0;
+    for (int prec = 1; prec <= 17; prec++) {
+        len = snprintf(buf, sizeof(buf), "%.*g", prec, val);
+        if (strtod(buf, NULL) == val) break;
+    }
+    emit_raw(e, buf, (usize)len);
+    if (!strpbrk(buf, ".eEin")) emit_lit(e, ".0");
+}
+
+/* Escape quote, backslash and control characters, the same as rapidjson. */
+static void emit_str(emitter *e, build_str str) {
+    static const char hex[] = "0123456789ABCDEF";
+    if (!str.str) {
+        emit_lit(e, "null");
+        return;
+    }
+    if (!emit_reserve(e, str.len * 6 + 2)) return;
+    char *cur = e->cur;
+    const u8 *src = (const u8 *)str.str, *end = src + str.len;
+    *cur++ = '"';
+    while (src < end) {
+        const u8 *run = src;
+        while (src < end && *src >= 0x20 && *src != '"' && *src != '\\') src++;
+        memcpy(cur, run, (usize)(src - run));
+        cur += src - run;
+        if (src == end) break;
+        u8 c = *src++;
+        *cur++ = '\\';
+        switch (c) {
+            case '"': *cur++ = '"'; break;
+            case '\\': *cur++ = '\\'; break;
+            case '\b': *cur++ = 'b'; break;
+            case '\f': *cur++ = 'f'; break;
+            case '\n': *cur++ = 'n'; break;
+            case '\r': *cur++ = 'r'; break;
+            case '\t': *cur++ = 't'; break;
+            default:
+                *cur++ = 'u';
+                *cur++ = '0';
+                *cur++ = '0';
+                *cur++ = hex[c >> 4];
+                *cur++ = hex[c & 0xF];
+                break;
+        }
+    }
+    *cur++ = '"';
+    e->cur = cur;
+}
+
+static void emit_uints(emitter *e, const u64 *vals, usize count) {
+    emit_char(e, '[');
+    for (usize i = 0; i < count; i++) {
+        if (i) emit_char(e, ',');
+        emit_u64(e, vals[i]);
+    }
+    emit_char(e, ']');
+}
+
+static void emit_twitter(emitter *e, const build_twitter *tw) {
+    emit_lit(e, "{\"statuses\":[");
+    for (usize i = 0; i < tw->status_count; i++) {
+        const build_status *s = tw->statuses + i;
+        const build_user *u = &s->user;
+        if (i) emit_char(e, ',');
+        emit_lit(e, "{\"created_at\":"); emit_str(e, s->created_at);
+        emit_lit(e, ",\"id\":"); emit_u64(e, s->id);
+        emit_lit(e, ",\"id_str\":"); emit_str(e, s->id_str);
+        emit_lit(e, ",\"text\":"); emit_str(e, s->text);
+        emit_lit(e, ",\"source\":"); emit_str(e, s->source);
+        emit_lit(e, ",\"truncated\":"); emit_bool(e, s->truncated);
+        emit_lit(e, ",\"in_reply_to_status_id\":"); emit_id(e, s->in_reply_to_status_id);
+        emit_lit(e, ",\"in_reply_to_status_id_str\":"); emit_str(e, s->in_reply_to_status_id_str);
+        emit_lit(e, ",\"in_reply_to_user_id\":"); emit_id(e, s->in_reply_to_user_id);
+        emit_lit(e, ",\"in_reply_to_user_id_str\":"); emit_str(e, s->in_reply_to_user_id_str);
+        emit_lit(e, ",\"in_reply_to_screen_name\":"); emit_str(e, s->in_reply_to_screen_name);
+        
+        emit_lit(e, ",\"user\":{\"id\":"); emit_u64(e, u->id);
+        emit_lit(e, ",\"id_str\":"); emit_str(e, u->id_str);
+        emit_lit(e, ",\"name\":"); emit_str(e, u->name);
+        emit_lit(e, ",\"screen_name\":"); emit_str(e, u->screen_name);
+        emit_lit(e, ",\"location\":"); emit_str(e, u->location);
+        emit_lit(e, ",\"description\":"); emit_str(e, u->description);
+        emit_lit(e, ",\"protected\":"); emit_bool(e, u->is_protected);
+        emit_lit(e, ",\"followers_count\":"); emit_u64(e, u->followers_count);
+        emit_lit(e, ",\"friends_count\":"); emit_u64(e, u->friends_count);
+        emit_lit(e, ",\"listed_count\":"); emit_u64(e, u->listed_count);
+        emit_lit(e, ",\"created_at\":"); emit_str(e, u->created_at);
+        emit_lit(e, ",\"favourites_count\":"); emit_u64(e, u->favourites_count);
+        emit_lit(e, ",\"verified\":"); emit_bool(e, u->verified);
+        emit_lit(e, ",\"statuses_count\":"); emit_u64(e, u->statuses_count);
+        emit_lit(e, ",\"lang\":"); emit_str(e, u->lang);
+        emit_lit(e, ",\"profile_image_url\":"); emit_str(e, u->profile_image_url);
+        
+        emit_lit(e, "},\"retweet_count\":"); emit_u64(e, s->retweet_count);
+        emit_lit(e, ",\"favorite_count\":"); emit_u64(e, s->favorite_count);
+        
+        emit_lit(e, ",\"entities\":{\"hashtags\":[");
+        for (usize t = 0; t < s->hashtag_count; t++) {
+            if (t) emit_char(e, ',');
+            emit_lit(e, "{\"text\":"); emit_str(e, s->hashtags[t].text);
+            emit_lit(e, ",\"indices\":"); emit_uints(e, s->hashtags[t].indices, 2);
+            emit_char(e, '}');
+        }
+        emit_lit(e, "],\"user_mentions\":[");
+        for (usize m = 0; m < s->mention_count; m++) {
+            const build_mention *men = s->mentions + m;
+            if (m) emit_char(e, ',');
+            emit_lit(e, "{\"screen_name\":"); emit_str(e, men->screen_name);
+            emit_lit(e, ",\"name\":"); emit_str(e, men->name);
+            emit_lit(e, ",\"id\":"); emit_u64(e, men->id);
+            emit_lit(e, ",\"id_str\":"); emit_str(e, men->id_str);
+            emit_lit(e, ",\"indices\":"); emit_uints(e, men->indices, 2);
+            emit_char(e, '}');
+        }
+        emit_lit(e, "]}");
+        
+        emit_lit(e, ",\"favorited\":"); emit_bool(e, s->favorited);
+        emit_lit(e, ",\"retweeted\":"); emit_bool(e, s->retweeted);
+        emit_lit(e, ",\"lang\":"); emit_str(e, s->lang);
+        emit_char(e, '}');
+    }
+    
+    emit_lit(e, "],\"search_metadata\":{\"completed_in\":"); emit_f64(e, tw->completed_in);
+    emit_lit(e, ",\"max_id\":"); emit_u64(e, tw->max_id);
+    emit_lit(e, ",\"max_id_str\":"); emit_str(e, tw->max_id_str);
+    emit_lit(e, ",\"next_results\":"); emit_str(e, tw->next_results);
+    emit_lit(e, ",\"query\":"); emit_str(e, tw->query);
+    emit_lit(e, ",\"refresh_url\":"); emit_str(e, tw->refresh_url);
+    emit_lit(e, ",\"count\":"); emit_u64(e, tw->count);
+    emit_lit(e, ",\"since_id\":"); emit_u64(e, tw->since_id);
+    emit_lit(e, ",\"since_id_str\":"); emit_str(e, tw->since_id_str);
+    emit_lit(e, "}}");
+}
+
+static void emit_citm(emitter *e, const build_citm *citm) {
+    emit_lit(e, "{\"events\":{");
+    for (usize i = 0; i < citm->event_count; i++) {
+        const build_event *evt = citm->events + i;
+        if (i) emit_char(e, ',');
+        emit_str(e, evt->key);
+        emit_lit(e, ":{\"description\":null,\"id\":"); emit_u64(e, evt->id);
+        emit_lit(e, ",\"logo\":"); emit_str(e, evt->logo);
+        emit_lit(e, ",\"name\":"); emit_str(e, evt->name);
+        emit_lit(e, ",\"subTopicIds\":"); emit_uints(e, evt->sub_topic_ids, evt->sub_topic_count);
+        emit_lit(e, ",\"subjectCode\":null,\"subtitle\":null,\"topicIds\":");
+        emit_uints(e, evt->topic_ids, evt->topic_count);
+        emit_char(e, '}');
+    }
+    
+    emit_lit(e, "},\"performances\":[");
+    for (usize i = 0; i < citm->performance_count; i++) {
+        const build_performance *p = citm->performances + i;
+        if (i) emit_char(e, ',');
+        emit_lit(e, "{\"eventId\":"); emit_u64(e, p->event_id);
+        emit_lit(e, ",\"id\":"); emit_u64(e, p->id);
+        emit_lit(e, ",\"logo\":"); emit_str(e, p->logo);
+        emit_lit(e, ",\"name\":null,\"prices\":[");
+        for (usize n = 0; n < p->price_count; n++) {
+            if (n) emit_char(e, ',');
+            emit_lit(e, "{\"amount\":"); emit_u64(e, p->prices[n].amount);
+            emit_lit(e, ",\"audienceSubCategoryId\":");
+            emit_u64(e, p->prices[n].audience_sub_category_id);
+            emit_lit(e, ",\"seatCategoryId\":"); emit_u64(e, p->prices[n].seat_category_id);
+            emit_char(e, '}');
+        }
+        emit_lit(e, "],\"seatCategories\":[");
+        for (usize n = 0; n < p->seat_category_count; n++) {
+            const build_seat_category *c = p->seat_categories + n;
+            if (n) emit_char(e, ',');
+            emit_lit(e, "{\"areas\":[");
+            for (usize a = 0; a < c->area_count; a++) {
+                if (a) emit_char(e, ',');
+                emit_lit(e, "{\"areaId\":"); emit_u64(e, c->area_ids[a]);
+                emit_lit(e, ",\"blockIds\":[]}");
+            }
+            emit_lit(e, "],\"seatCategoryId\":"); emit_u64(e, c->seat_category_id);
+            emit_char(e, '}');
+        }
+        emit_lit(e, "],\"seatMapImage\":null,\"start\":"); emit_u64(e, p->start);
+        emit_lit(e, ",\"venueCode\":"); emit_str(e, p->venue_code);
+        emit_char(e, '}');
+    }
+    emit_char(e, ']');
+    
+    for (usize m = 0; m < citm->map_count; m++) {
+        const build_name_map *map = citm->maps + m;
+        emit_char(e, ',');
+        emit_str(e, map->name);
+        emit_lit(e, ":{");
+        for (usize n = 0; n < map->count; n++) {
+            if (n) emit_char(e, ',');
+            emit_str(e, map->names[n].key);
+            emit_char(e, ':');
+            emit_str(e, map->names[n].name);
+        }
+        emit_char(e, '}');
+    }
+    emit_char(e, '}');
+}
+
+u64 stream_measure_emitter(const build_data *data, char **out,
+                           size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        emitter e;
+        benchmark_tick_begin();
+        e.hdr = malloc(EMITTER_INIT_CAP);
+        e.cur = e.hdr;
+        e.end = e.hdr ? e.hdr + EMITTER_INIT_CAP : NULL;
+        e.failed = !e.hdr;
+        if (data->twitter) emit_twitter(&e, data->twitter);
+        else emit_citm(&e, data->citm);
+        emit_char(&e, '\0');
+        benchmark_tick_end();
+        if (e.failed) {
+            free(e.hdr);
+            return 0;
+        }
+        if (i + 1 == repeat) {
+            *out = e.hdr;
+            *out_size = (usize)(e.cur - e.hdr) - 1;
+        } else {
+            free(e.hdr);
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// roofline (one pass over the input, the upper bound of a reader)
+
+/* The result of each kernel is stored here, so the pass is not optimized out. */
+static volatile usize roofline_sink;
+
+u64 roofline_measure_memcpy(const char *json, size_t size, int repeat) {
+    benchmark_tick_init();
+    
+    char *buf = malloc(size + 1);
+    if (!buf) return 0;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        memcpy(buf, json, size);
+        benchmark_tick_end();
+        roofline_sink = (usize)buf[size / 2];
+    }
+    free(buf);
+    
+    return benchmark_tick_min();
+}
+
+u64 roofline_measure_memchr(const char *json, size_t size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        const char *cur = json, *end = json + size;
+        benchmark_tick_begin();
+        while ((cur = memchr(cur, '"', (usize)(end - cur)))) {
+            num++;
+            cur++;
+        }
+        benchmark_tick_end();
+        roofline_sink = num;
+    }
+    
+    return benchmark_tick_min();
+}
+
+/* Whether the byte is structural: {}[]:, quote or backslash. */
+static const bool roofline_structural[256] = {
+    ['{'] = true, ['}'] = true, ['['] = true, [']'] = true,
+    [':'] = true, [','] = true, ['"'] = true, ['\\'] = true
+};
+
+/* Count the structural bytes, 16 bytes per iteration if SIMD is available. */
+static usize roofline_classify(const u8 *cur, const u8 *end) {
+    usize num = 0;
+#if ROOFLINE_HAS_SSE2
+    const __m128i v_lbrace = _mm_set1_epi8('{'), v_rbrace = _mm_set1_epi8('}');
+    const __m128i v_comma = _mm_set1_epi8(','), v_colon = _mm_set1_epi8(':');
+    const __m128i v_quote = _mm_set1_epi8('"'), v_bslash = _mm_set1_epi8('\\');
+    const __m128i v_lbracket = _mm_set1_epi8('['), v_rbracket = _mm_set1_epi8(']');
+    for (; end - cur >= 16; cur += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)cur);
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, v_lbrace), _mm_cmpeq_epi8(v, v_rbrace));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, v_lbracket));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, v_rbracket));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, v_comma));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, v_colon));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, v_quote));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, v_bslash));
+        u32 mask = (u32)_mm_movemask_epi8(m);
+        while (mask) {
+            mask &= mask - 1;
+            num++;
+        }
+    }
+#elif ROOFLINE_HAS_NEON
+    const uint8x16_t v_lbrace = vdupq_n_u8('{'), v_rbrace = vdupq_n_u8('}');
+    const uint8x16_t v_comma = vdupq_n_u8(','), v_colon = vdupq_n_u8(':');
+    const uint8x16_t v_quote = vdupq_n_u8('"'), v_bslash = vdupq_n_u8('\\');
+    const uint8x16_t v_lbracket = vdupq_n_u8('['), v_rbracket = vdupq_n_u8(']');
+    const uint8x16_t v_one = vdupq_n_u8(1);
+    for (; end - cur >= 16; cur += 16) {
+        uint8x16_t v = vld1q_u8(cur);
+        uint8x16_t m = vorrq_u8(vceqq_u8(v, v_lbrace), vceqq_u8(v, v_rbrace));
+        m = vorrq_u8(m, vceqq_u8(v, v_lbracket));
+        m = vorrq_u8(m, vceqq_u8(v, v_rbracket));
+        m = vorrq_u8(m, vceqq_u8(v, v_comma));
+        m = vorrq_u8(m, vceqq_u8(v, v_colon));
+        m = vorrq_u8(m, vceqq_u8(v, v_quote));
+        m = vorrq_u8(m, vceqq_u8(v, v_bslash));
+        num += vaddvq_u8(vandq_u8(m, v_one));
+    }
+#endif
+    for (; cur < end; cur++) num += roofline_structural[*cur];
+    return num;
+}
+
+u64 roofline_measure_classify(const char *json, size_t size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        usize num = roofline_classify((const u8 *)json, (const u8 *)json + size);
+        benchmark_tick_end();
+        roofline_sink = num;
+    }
+    
+    return benchmark_tick_min();
+}
+
+u64 roofline_measure_utf8(const char *json, size_t size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        bool valid = json_utf8_validate(JSON_UTF8_SCALAR, json, size);
+        benchmark_tick_end();
+        if (!valid) return 0;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// scan (structural index only, see json_scan.c)
+
+u64 scan_measure_isa(json_scan_isa isa, const char *json, size_t size,
+                     usize *count, int repeat) {
+    benchmark_tick_init();
+    
+    u32 *idx = malloc((size + 1) * sizeof(u32));
+    if (!idx) return 0;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        usize num = json_scan_index(isa, json, size, idx);
+        benchmark_tick_end();
+        if (num == SIZE_MAX) {
+            free(idx);
+            return 0;
+        }
+        *count = num;
+    }
+    free(idx);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// utf8 (standalone validator, see json_utf8.c)
+
+u64 utf8_measure_validator(json_utf8_impl impl, const char *json, size_t size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        bool valid = json_utf8_validate(impl, json, size);
+        benchmark_tick_end();
+        if (!valid) return 0;
+    }
+    
+    return benchmark_tick_min();
+}
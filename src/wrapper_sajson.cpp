@@ -5,7 +5,8 @@ extern "C" {
 // -----------------------------------------------------------------------------
 // reader
 
-u64 reader_measure_sajson(const char *json, size_t size, int repeat) {
+u64 reader_measure_sajson(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
     benchmark_tick_init();
     
     char *buf = (char *)malloc(size);
@@ -20,11 +21,13 @@ u64 reader_measure_sajson(const char *json, size_t size, int repeat) {
     }
     free((void *)buf);
     
+    *valid = true;
     return benchmark_tick_min();
 }
 
 
-u64 reader_measure_sajson_dynamic(const char *json, size_t size, int repeat) {
+u64 reader_measure_sajson_dynamic(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
     benchmark_tick_init();
     
     char *buf = (char *)malloc(size);
@@ -38,6 +41,7 @@ u64 reader_measure_sajson_dynamic(const char *json, size_t size, int repeat) {
     }
     free((void *)buf);
     
+    *valid = true;
     return benchmark_tick_min();
 }
 
@@ -112,4 +116,140 @@ u64 stats_measure_sajson(const char *json, size_t size, stats_data *data, int re
 
 
 
+// -----------------------------------------------------------------------------
+// number reader
+
+u64 number_reader_measure_sajson(const number_data *data, f64 *vals,
+                                 bool single, int repeat) {
+    // sajson requires the root to be an array or object
+    if (single) return 0;
+    
+    benchmark_tick_init();
+    
+    char *buf = (char *)malloc(data->array_size);
+    for (int i = 0; i < repeat; i++) {
+        memcpy((void *)buf, (const void *)data->array, data->array_size);
+        benchmark_tick_begin();
+        const sajson::document& doc = sajson::parse(sajson::dynamic_allocation(),
+                                                    sajson::mutable_string_view(data->array_size, buf));
+        if (doc.is_valid()) {
+            const sajson::value& root = doc.get_root();
+            auto length = root.get_length();
+            for (size_t n = 0; n < length; n++) {
+                vals[n] = root.get_array_element(n).get_number_value();
+            }
+        }
+        benchmark_tick_end();
+        if (!doc.is_valid()) {
+            free((void *)buf);
+            return 0;
+        }
+    }
+    free((void *)buf);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// blob
+
+u64 blob_measure_sajson(const char *json, size_t size, bool insitu,
+                        usize *mem, int repeat) {
+    // sajson always parses in-situ, the strings point into the input
+    if (!insitu) return 0;
+    
+    benchmark_tick_init();
+    
+    char *buf = (char *)malloc(size);
+    size_t *ast_buf = (size_t *)malloc(size * sizeof(size_t));
+    if (!buf || !ast_buf) {
+        free((void *)buf);
+        free((void *)ast_buf);
+        return 0;
+    }
+    for (int i = 0; i < repeat; i++) {
+        memcpy((void *)buf, (void *)json, size);
+        benchmark_tick_begin();
+        const sajson::document& doc = sajson::parse(sajson::bounded_allocation(ast_buf, size),
+                                                    sajson::mutable_string_view(size, buf));
+        benchmark_tick_end();
+        if (!doc.is_valid()) {
+            free((void *)buf);
+            free((void *)ast_buf);
+            return 0;
+        }
+    }
+    // the AST buffer is sized for the worst case (one word per input byte),
+    // count the words written by one more untimed run on a marked buffer
+    memset((void *)ast_buf, 0xFF, size * sizeof(size_t));
+    memcpy((void *)buf, (void *)json, size);
+    {
+        const sajson::document& doc = sajson::parse(sajson::bounded_allocation(ast_buf, size),
+                                                    sajson::mutable_string_view(size, buf));
+        usize used = 0;
+        for (usize n = 0; n < size; n++) used += ast_buf[n] != SIZE_MAX;
+        *mem = doc.is_valid() ? used * sizeof(size_t) : 0;
+    }
+    free((void *)buf);
+    free((void *)ast_buf);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// nested
+
+u64 nested_measure_sajson(const char *json, size_t size, nested_mode mode,
+                          usize *count, int repeat) {
+    // sajson always parses in-situ, the payload is unescaped in the buffer
+    // and the inner document is parsed in place
+    if (mode != NESTED_INSITU) return 0;
+    
+    benchmark_tick_init();
+    
+    char *buf = (char *)malloc(size);
+    if (!buf) return 0;
+    for (int i = 0; i < repeat; i++) {
+        memcpy((void *)buf, (void *)json, size);
+        usize num = 0;
+        benchmark_tick_begin();
+        const sajson::document& doc = sajson::parse(sajson::dynamic_allocation(),
+                                                    sajson::mutable_string_view(size, buf));
+        bool suc = doc.is_valid() && doc.get_root().get_type() == sajson::TYPE_ARRAY;
+        size_t msg_num = suc ? doc.get_root().get_length() : 0;
+        for (size_t m = 0; m < msg_num; m++) {
+            const sajson::value& msg = doc.get_root().get_array_element(m);
+            if (msg.get_type() != sajson::TYPE_OBJECT) {
+                suc = false;
+                break;
+            }
+            size_t idx = msg.find_object_key(sajson::literal("payload"));
+            if (idx == msg.get_length() || msg.get_object_value(idx).get_type() != sajson::TYPE_STRING) {
+                suc = false;
+                break;
+            }
+            const sajson::value& payload = msg.get_object_value(idx);
+            const sajson::document& inner = sajson::parse(sajson::dynamic_allocation(),
+                sajson::mutable_string_view(payload.get_string_length(), (char *)payload.as_cstring()));
+            if (!inner.is_valid()) {
+                suc = false;
+                break;
+            }
+            num++;
+        }
+        benchmark_tick_end();
+        if (!suc) {
+            free((void *)buf);
+            return 0;
+        }
+        *count = num;
+    }
+    free((void *)buf);
+    
+    return benchmark_tick_min();
+}
+
+
 }
@@ -7,7 +7,8 @@ extern "C" {
 // -----------------------------------------------------------------------------
 // reader
 
-u64 reader_measure_simdjson(const char *json, size_t size, int repeat) {
+u64 reader_measure_simdjson(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
     benchmark_tick_init();
     
     simdjson::dom::parser parser;
@@ -20,6 +21,7 @@ u64 reader_measure_simdjson(const char *json, size_t size, int repeat) {
         if (error) return 0;
     }
     
+    *valid = true;
     return benchmark_tick_min();
 }
 
@@ -127,5 +129,957 @@ u64 stats_measure_simdjson(const char *json, size_t size, stats_data *data, int
 
 
 
+// -----------------------------------------------------------------------------
+// parallel reader
+
+struct parallel_reader_ctx {
+    const char *json;
+    usize *splits;
+    simdjson::dom::parser *parsers;
+    usize *counts;
+    bool *failed;
+};
+
+static void parallel_reader_task(void *ctx_ptr, int idx) {
+    parallel_reader_ctx *ctx = (parallel_reader_ctx *)ctx_ptr;
+    usize beg = ctx->splits[idx] + 1;
+    usize len = ctx->splits[idx + 1] - beg;
+    
+    // wrap the segment as an array, with simdjson padding
+    char *buf = (char *)malloc(len + 2 + simdjson::SIMDJSON_PADDING);
+    if (!buf) {
+        ctx->failed[idx] = true;
+        ctx->counts[idx] = 0;
+        return;
+    }
+    buf[0] = '[';
+    memcpy(buf + 1, ctx->json + beg, len);
+    buf[len + 1] = ']';
+    memset(buf + len + 2, 0, simdjson::SIMDJSON_PADDING);
+    
+    simdjson::dom::array array;
+    simdjson::error_code error;
+    ctx->parsers[idx].parse(buf, len + 2, false).get_array().tie(array, error);
+    ctx->failed[idx] = (error != simdjson::SUCCESS);
+    ctx->counts[idx] = error ? 0 : array.size();
+    free(buf);
+}
+
+u64 parallel_reader_measure_simdjson(const char *json, size_t size,
+                                     int thread_count, int repeat) {
+    benchmark_tick_init();
+    
+    // the serial baseline does the same padded copy as a segment
+    if (thread_count <= 1) {
+        simdjson::dom::parser parser;
+        simdjson::dom::element root;
+        simdjson::error_code error;
+        for (int i = 0; i < repeat; i++) {
+            benchmark_tick_begin();
+            char *buf = (char *)malloc(size + simdjson::SIMDJSON_PADDING);
+            error = simdjson::MEMALLOC;
+            if (buf) {
+                memcpy(buf, json, size);
+                memset(buf + size, 0, simdjson::SIMDJSON_PADDING);
+                parser.parse(buf, size, false).tie(root, error);
+            }
+            benchmark_tick_end();
+            free(buf);
+            if (error) return 0;
+        }
+        return benchmark_tick_min();
+    }
+    
+    // several segments per thread for load balancing, one parser per segment
+    int seg_max = thread_count * 4;
+    yy_thread_pool *pool = yy_thread_pool_new(thread_count);
+    std::vector<simdjson::dom::parser> parsers(seg_max);
+    std::vector<usize> splits(seg_max + 1);
+    std::vector<usize> counts(seg_max);
+    std::unique_ptr<bool[]> failed(new bool[seg_max]);
+    parallel_reader_ctx ctx;
+    ctx.json = json;
+    ctx.splits = splits.data();
+    ctx.parsers = parsers.data();
+    ctx.counts = counts.data();
+    ctx.failed = failed.get();
+    
+    bool suc = (pool != NULL);
+    for (int i = 0; i < repeat && suc; i++) {
+        benchmark_tick_begin();
+        int seg_num = json_array_split(json, size, ctx.splits, seg_max, pool);
+        if (seg_num) yy_thread_pool_run(pool, parallel_reader_task, &ctx, seg_num);
+        benchmark_tick_end();
+        
+        // the segment docs together should be same as the serial result
+        usize elem_num = 0;
+        if (!seg_num) suc = false;
+        for (int s = 0; s < seg_num; s++) {
+            if (ctx.failed[s]) suc = false;
+            elem_num += ctx.counts[s];
+        }
+        if (i == 0 && suc) {
+            simdjson::dom::parser parser;
+            simdjson::dom::array array;
+            simdjson::error_code error;
+            parser.parse(json, size).get_array().tie(array, error);
+            suc = !error && elem_num == array.size();
+        }
+    }
+    
+    yy_thread_pool_free(pool);
+    
+    return suc ? benchmark_tick_min() : 0;
+}
+
+
+
+// -----------------------------------------------------------------------------
+// number reader
+
+u64 number_reader_measure_simdjson(const number_data *data, f64 *vals,
+                                   bool single, int repeat) {
+    benchmark_tick_init();
+    
+    simdjson::dom::parser parser;
+    for (int i = 0; i < repeat; i++) {
+        if (single) {
+            benchmark_tick_begin();
+            for (usize n = 0; n < data->count; n++) {
+                // the literals are padded, no need to copy
+                double v;
+                simdjson::error_code error = parser.parse(data->strs[n], data->lens[n], false).get_double().get(v);
+                vals[n] = error ? NAN : v;
+            }
+            benchmark_tick_end();
+        } else {
+            simdjson::dom::array array;
+            simdjson::error_code error;
+            benchmark_tick_begin();
+            parser.parse(data->array, data->array_size).get_array().tie(array, error);
+            usize idx = 0;
+            if (!error) {
+                for (auto val : array) {
+                    double v;
+                    vals[idx++] = val.get_double().get(v) ? NAN : v;
+                }
+            }
+            benchmark_tick_end();
+            if (error) return 0;
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+
+// -----------------------------------------------------------------------------
+// roundtrip
+
+u64 roundtrip_measure_simdjson(const char *json, size_t size, size_t *out_size,
+                               bool *roundtrip, int repeat) {
+    benchmark_tick_init();
+    
+    simdjson::dom::parser parser;
+    simdjson::dom::element doc;
+    simdjson::error_code error;
+    *roundtrip = true;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        parser.parse(json, size).tie(doc, error);
+        std::string str;
+        if (!error) str = simdjson::minify(doc);
+        benchmark_tick_end();
+        if (error || str.length() == 0) return 0;
+        *out_size = str.length();
+        if (*out_size != size || memcmp(json, str.c_str(), size) != 0) *roundtrip = false;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+
+// -----------------------------------------------------------------------------
+// lookup
+
+static bool lookup_resolve(simdjson::dom::element val, const lookup_target *target,
+                           simdjson::dom::object &obj) {
+    for (usize d = 0; d < target->depth; d++) {
+        simdjson::error_code error;
+        if (val.is_array()) {
+            error = val.at(strtoull(target->path[d], NULL, 10)).get(val);
+        } else {
+            error = val.at_key(target->path[d]).get(val);
+        }
+        if (error) return false;
+    }
+    return val.get(obj) == simdjson::SUCCESS;
+}
+
+u64 lookup_measure_simdjson(const char *json, size_t size,
+                            const lookup_target *targets, usize target_count,
+                            usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    simdjson::dom::parser parser;
+    simdjson::dom::element root;
+    if (parser.parse(json, size).get(root)) return 0;
+    std::vector<simdjson::dom::object> objs(target_count);
+    bool suc = true;
+    for (usize t = 0; t < target_count; t++) {
+        if (!lookup_resolve(root, targets + t, objs[t])) suc = false;
+    }
+    
+    for (int i = 0; i < repeat && suc; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize t = 0; t < target_count; t++) {
+            const lookup_target *target = targets + t;
+            for (usize k = 0; k < target->key_count; k++) {
+                std::string_view key(target->keys[k], target->key_lens[k]);
+                num += objs[t].at_key(key).error() == simdjson::SUCCESS;
+            }
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    return suc ? benchmark_tick_min() : 0;
+}
+
+
+
+// -----------------------------------------------------------------------------
+// pointer
+
+static yy_inline bool pointer_walk(simdjson::dom::element val, const json_ptr_token *tokens,
+                                   usize count) {
+    for (usize t = 0; t < count; t++) {
+        usize idx;
+        simdjson::error_code error;
+        if (val.is_object()) {
+            error = val.at_key(std::string_view(tokens[t].str, tokens[t].len)).get(val);
+        } else if (val.is_array() && json_pointer_token_to_index(tokens + t, &idx)) {
+            error = val.at(idx).get(val);
+        } else {
+            return false;
+        }
+        if (error) return false;
+    }
+    return true;
+}
+
+u64 pointer_measure_simdjson(const char *json, size_t size, const pointer_data *data,
+                             bool walk_only, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    simdjson::dom::parser parser;
+    simdjson::dom::element root;
+    if (parser.parse(json, size).get(root)) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        if (walk_only) {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                num += pointer_walk(root, data->tokens[p], data->token_counts[p]);
+            }
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                std::string_view ptr(data->ptrs[p], data->lens[p]);
+                num += root.at_pointer(ptr).error() == simdjson::SUCCESS;
+            }
+            benchmark_tick_end();
+        }
+        *found = num;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// path
+
+static_assert(sizeof(simdjson::dom::element) <= sizeof(json_path_val),
+              "dom::element should fit in json_path_val");
+
+static yy_inline simdjson::dom::element path_elem(json_path_val val) {
+    simdjson::dom::element elem;
+    memcpy((void *)&elem, (const void *)&val, sizeof(elem));
+    return elem;
+}
+
+static yy_inline json_path_val path_val(simdjson::dom::element elem) {
+    json_path_val val = { NULL, 0 };
+    memcpy((void *)&val, (const void *)&elem, sizeof(elem));
+    return val;
+}
+
+static json_path_type path_get_type(json_path_val val) {
+    switch (path_elem(val).type()) {
+        case simdjson::dom::element_type::ARRAY: return JSON_PATH_ARR;
+        case simdjson::dom::element_type::OBJECT: return JSON_PATH_OBJ;
+        case simdjson::dom::element_type::INT64:
+        case simdjson::dom::element_type::UINT64:
+        case simdjson::dom::element_type::DOUBLE: return JSON_PATH_NUM;
+        case simdjson::dom::element_type::STRING: return JSON_PATH_STR;
+        case simdjson::dom::element_type::BOOL: return JSON_PATH_BOOL;
+        case simdjson::dom::element_type::NULL_VALUE: return JSON_PATH_NULL;
+        default: return JSON_PATH_NONE;
+    }
+}
+
+static bool path_get_bool(json_path_val val) {
+    return path_elem(val).get_bool().value_unsafe();
+}
+
+static f64 path_get_num(json_path_val val) {
+    return path_elem(val).get_double().value_unsafe();
+}
+
+static const char *path_get_str(json_path_val val, usize *len) {
+    std::string_view str = path_elem(val).get_string().value_unsafe();
+    *len = str.size();
+    return str.data();
+}
+
+static usize path_arr_size(json_path_val val) {
+    return path_elem(val).get_array().value_unsafe().size();
+}
+
+static bool path_arr_get(json_path_val val, usize idx, json_path_val *out) {
+    simdjson::dom::element sub;
+    if (path_elem(val).get_array().value_unsafe().at(idx).get(sub)) return false;
+    *out = path_val(sub);
+    return true;
+}
+
+static bool path_obj_get(json_path_val val, const char *key, usize key_len,
+                         json_path_val *out) {
+    simdjson::dom::element sub;
+    simdjson::dom::object obj = path_elem(val).get_object().value_unsafe();
+    if (obj.at_key(std::string_view(key, key_len)).get(sub)) return false;
+    *out = path_val(sub);
+    return true;
+}
+
+static void path_foreach(json_path_val val, json_path_each_func func, void *ctx) {
+    simdjson::dom::element elem = path_elem(val);
+    simdjson::dom::object obj;
+    simdjson::dom::array arr;
+    if (elem.get(obj) == simdjson::SUCCESS) {
+        for (simdjson::dom::key_value_pair field : obj) {
+            func(ctx, field.key.data(), field.key.size(), path_val(field.value));
+        }
+    } else if (elem.get(arr) == simdjson::SUCCESS) {
+        for (simdjson::dom::element sub : arr) {
+            func(ctx, NULL, 0, path_val(sub));
+        }
+    }
+}
+
+static const json_path_adapter path_adapter = {
+    path_get_type, path_get_bool, path_get_num, path_get_str,
+    path_arr_size, path_arr_get, path_obj_get, path_foreach
+};
+
+u64 path_measure_simdjson(const char *json, size_t size, const json_path *path,
+                          bool with_parse, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    simdjson::dom::parser parser;
+    simdjson::dom::element root;
+    if (parser.parse(json, size).get(root)) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        if (with_parse) {
+            benchmark_tick_begin();
+            simdjson::error_code error = parser.parse(json, size).get(root);
+            if (!error) *found = json_path_eval(path, &path_adapter, path_val(root));
+            benchmark_tick_end();
+            if (error) return 0;
+        } else {
+            benchmark_tick_begin();
+            *found = json_path_eval(path, &path_adapter, path_val(root));
+            benchmark_tick_end();
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+/*
+ Streaming evaluation on On-Demand API, no DOM is built.
+ The active steps of each value are tracked as a bit set, which is passed down
+ while the document is iterated once. A filter can only be the last step, and
+ is tested while the members of the candidate object are iterated.
+ */
+
+typedef struct {
+    const json_path *path;
+    const json_path_step *last;
+    u64 final;          /* bit of the final state (all steps matched) */
+    usize found;
+} path_stream_ctx;
+
+static bool path_stream_supported(const json_path *path) {
+    if (path->count >= 64) return false;
+    for (usize i = 0; i < path->count; i++) {
+        const json_path_step *step = path->steps + i;
+        if (step->type == JSON_PATH_STEP_INDEX && step->start < 0) return false;
+        if (step->type == JSON_PATH_STEP_SLICE &&
+            (step->step <= 0 || step->start < 0 || step->end < 0)) return false;
+        if (step->type == JSON_PATH_STEP_FILTER && i + 1 != path->count) return false;
+    }
+    return true;
+}
+
+/* Returns the states of a child value, `cand` is set if the child is tested by filter. */
+static u64 path_stream_next(path_stream_ctx *ctx, u64 states, std::string_view key,
+                            bool is_key, i64 idx, bool *cand) {
+    u64 next = 0;
+    *cand = false;
+    for (usize i = 0; states; i++, states >>= 1) {
+        if (!(states & 1)) continue;
+        const json_path_step *step = ctx->path->steps + i;
+        bool select = false;
+        if (step->descendant) next |= (u64)1 << i;
+        switch (step->type) {
+            case JSON_PATH_STEP_NAME:
+                select = is_key && key == std::string_view(step->name, step->name_len);
+                break;
+            case JSON_PATH_STEP_WILDCARD:
+                select = true;
+                break;
+            case JSON_PATH_STEP_INDEX:
+                select = !is_key && idx == step->start;
+                break;
+            case JSON_PATH_STEP_SLICE:
+                select = !is_key && idx >= step->start &&
+                    (!step->has_end || idx < step->end) &&
+                    (idx - step->start) % step->step == 0;
+                break;
+            case JSON_PATH_STEP_FILTER:
+                *cand = true;
+                break;
+        }
+        if (select) next |= (u64)1 << (i + 1);
+    }
+    if (next & ctx->final) {
+        ctx->found++;
+        next &= ~ctx->final;
+    }
+    return next;
+}
+
+static simdjson::error_code path_stream_test(simdjson::ondemand::value &val,
+                                             simdjson::ondemand::json_type jt,
+                                             const json_path_step *step, bool *match) {
+    json_path_type type = JSON_PATH_NONE;
+    bool b = false;
+    f64 num = 0;
+    std::string_view str;
+    simdjson::error_code error = simdjson::SUCCESS;
+    switch (jt) {
+        case simdjson::ondemand::json_type::array: type = JSON_PATH_ARR; break;
+        case simdjson::ondemand::json_type::object: type = JSON_PATH_OBJ; break;
+        case simdjson::ondemand::json_type::number:
+            type = JSON_PATH_NUM;
+            error = val.get_double().get(num);
+            break;
+        case simdjson::ondemand::json_type::string:
+            type = JSON_PATH_STR;
+            error = val.get_string().get(str);
+            break;
+        case simdjson::ondemand::json_type::boolean:
+            type = JSON_PATH_BOOL;
+            error = val.get_bool().get(b);
+            break;
+        case simdjson::ondemand::json_type::null:
+            type = JSON_PATH_NULL;
+            break;
+        default:
+            break;
+    }
+    *match = !error && json_path_filter_match(step, type, b, num, str.data(), str.size());
+    return error;
+}
+
+static simdjson::error_code path_stream_value(path_stream_ctx *ctx,
+                                              simdjson::ondemand::value val,
+                                              u64 states, bool cand) {
+    simdjson::ondemand::json_type jt;
+    simdjson::error_code error = val.type().get(jt);
+    if (error) return error;
+    const json_path_step *last = ctx->last;
+    bool match = false, test_key = cand && last->name;
+    
+    if (cand && !last->name) {
+        if ((error = path_stream_test(val, jt, last, &match))) return error;
+        if (match) ctx->found++;
+    }
+    
+    if (jt == simdjson::ondemand::json_type::object) {
+        simdjson::ondemand::object obj;
+        if ((error = val.get_object().get(obj))) return error;
+        for (auto field_result : obj) {
+            simdjson::ondemand::field field;
+            std::string_view key;
+            bool sub_cand;
+            if ((error = std::move(field_result).get(field))) return error;
+            if ((error = field.unescaped_key().get(key))) return error;
+            u64 next = path_stream_next(ctx, states, key, true, -1, &sub_cand);
+            bool test = test_key && !match &&
+                key == std::string_view(last->name, last->name_len);
+            if (!next && !sub_cand && !test) continue;
+            
+            simdjson::ondemand::value sub = field.value();
+            if (test) {
+                simdjson::ondemand::json_type sub_jt;
+                if ((error = sub.type().get(sub_jt))) return error;
+                if ((error = path_stream_test(sub, sub_jt, last, &match))) return error;
+                if (sub_jt != simdjson::ondemand::json_type::object &&
+                    sub_jt != simdjson::ondemand::json_type::array) continue;
+            }
+            if ((error = path_stream_value(ctx, sub, next, sub_cand))) return error;
+        }
+        if (test_key && match) ctx->found++;
+    } else if (jt == simdjson::ondemand::json_type::array) {
+        simdjson::ondemand::array arr;
+        if ((error = val.get_array().get(arr))) return error;
+        i64 idx = 0;
+        for (auto sub_result : arr) {
+            simdjson::ondemand::value sub;
+            bool sub_cand;
+            if ((error = std::move(sub_result).get(sub))) return error;
+            u64 next = path_stream_next(ctx, states, std::string_view(), false, idx++, &sub_cand);
+            if (!next && !sub_cand) continue;
+            if ((error = path_stream_value(ctx, sub, next, sub_cand))) return error;
+        }
+    }
+    return simdjson::SUCCESS;
+}
+
+u64 path_measure_simdjson_ondemand(const char *json, size_t size, const json_path *path,
+                                   bool with_parse, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    if (!with_parse || !path_stream_supported(path)) return 0;
+    simdjson::padded_string padded(json, size);
+    simdjson::ondemand::parser parser;
+    path_stream_ctx ctx;
+    ctx.path = path;
+    ctx.last = path->count ? path->steps + path->count - 1 : NULL;
+    ctx.final = (u64)1 << path->count;
+    
+    for (int i = 0; i < repeat; i++) {
+        simdjson::ondemand::document doc;
+        simdjson::ondemand::value root;
+        simdjson::error_code error;
+        ctx.found = 0;
+        benchmark_tick_begin();
+        error = parser.iterate(padded).get(doc);
+        if (!error) error = doc.get_value().get(root);
+        if (!error) {
+            if (path->count == 0) ctx.found = 1;
+            else error = path_stream_value(&ctx, root, 1, false);
+        }
+        benchmark_tick_end();
+        if (error) return 0;
+        *found = ctx.found;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// index
+
+u64 index_measure_simdjson(const char *json, size_t size, const usize *idxs,
+                           usize idx_count, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    simdjson::dom::parser parser;
+    simdjson::dom::array arr;
+    if (parser.parse(json, size).get(arr)) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize n = 0; n < idx_count; n++) {
+            num += arr.at(idxs[n]).error() == simdjson::SUCCESS;
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// sax
+
+extern "C++" {
+
+/* The value may be a document or a value, scalar documents have no value view. */
+template <typename T>
+static simdjson::error_code sax_value(T &val, stats_data *data) {
+    simdjson::ondemand::json_type jt;
+    simdjson::error_code error = val.type().get(jt);
+    if (error) return error;
+    switch (jt) {
+        case simdjson::ondemand::json_type::object: {
+            simdjson::ondemand::object obj;
+            if ((error = val.get_object().get(obj))) return error;
+            for (auto field_result : obj) {
+                simdjson::ondemand::field field;
+                std::string_view key;
+                if ((error = std::move(field_result).get(field))) return error;
+                if ((error = field.unescaped_key().get(key))) return error;
+                simdjson::ondemand::value sub = field.value();
+                data->num_string++;
+                if ((error = sax_value(sub, data))) return error;
+            }
+            data->num_object++;
+            break;
+        }
+        case simdjson::ondemand::json_type::array: {
+            simdjson::ondemand::array arr;
+            if ((error = val.get_array().get(arr))) return error;
+            for (auto sub_result : arr) {
+                simdjson::ondemand::value sub;
+                if ((error = std::move(sub_result).get(sub))) return error;
+                if ((error = sax_value(sub, data))) return error;
+            }
+            data->num_array++;
+            break;
+        }
+        case simdjson::ondemand::json_type::number: {
+            f64 num;
+            if ((error = val.get_double().get(num))) return error;
+            data->num_number++;
+            break;
+        }
+        case simdjson::ondemand::json_type::string: {
+            std::string_view str;
+            if ((error = val.get_string().get(str))) return error;
+            data->num_string++;
+            break;
+        }
+        case simdjson::ondemand::json_type::boolean: {
+            bool b;
+            if ((error = val.get_bool().get(b))) return error;
+            if (b) data->num_true++;
+            else data->num_false++;
+            break;
+        }
+        case simdjson::ondemand::json_type::null: {
+            bool is_null;
+            if ((error = val.is_null().get(is_null))) return error;
+            if (!is_null) return simdjson::INCORRECT_TYPE;
+            data->num_null++;
+            break;
+        }
+        default:
+            return simdjson::INCORRECT_TYPE;
+    }
+    return simdjson::SUCCESS;
+}
+
+} // extern "C++"
+
+u64 sax_measure_simdjson(const char *json, size_t size, stats_data *data, int repeat) {
+    benchmark_tick_init();
+    
+    // On-Demand forward iteration, every value is visited once
+    simdjson::padded_string padded(json, size);
+    simdjson::ondemand::parser parser;
+    
+    for (int i = 0; i < repeat; i++) {
+        simdjson::ondemand::document doc;
+        simdjson::error_code error;
+        memset(data, 0, sizeof(stats_data));
+        benchmark_tick_begin();
+        error = parser.iterate(padded).get(doc);
+        if (!error) error = sax_value(doc, data);
+        if (!error && !doc.at_end()) error = simdjson::TRAILING_CONTENT;
+        benchmark_tick_end();
+        if (error) return 0;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// ondemand
+
+u64 reader_measure_simdjson_ondemand(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
+    benchmark_tick_init();
+    
+    // On-Demand parses lazily, so every value is visited and decoded once.
+    // The padded copy is made inside the timing, as the DOM reader's parse()
+    // copies the input to a padded buffer on each call.
+    simdjson::ondemand::parser parser;
+    stats_data data;
+    memset(&data, 0, sizeof(stats_data));
+    
+    for (int i = 0; i < repeat; i++) {
+        simdjson::error_code error;
+        benchmark_tick_begin();
+        {
+            simdjson::padded_string padded(json, size);
+            simdjson::ondemand::document doc;
+            error = parser.iterate(padded).get(doc);
+            if (!error) error = sax_value(doc, &data);
+            if (!error && !doc.at_end()) error = simdjson::TRAILING_CONTENT;
+        }
+        benchmark_tick_end();
+        if (error) return 0;
+    }
+    
+    *valid = true;
+    return benchmark_tick_min();
+}
+
+u64 stats_measure_simdjson_ondemand(const char *json, size_t size, stats_data *data, int repeat) {
+    benchmark_tick_init();
+    
+    // the structural index is built once, each loop rewinds and walks the values
+    simdjson::padded_string padded(json, size);
+    simdjson::ondemand::parser parser;
+    simdjson::ondemand::document doc;
+    if (parser.iterate(padded).get(doc)) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        simdjson::error_code error;
+        memset(data, 0, sizeof(stats_data));
+        doc.rewind();
+        benchmark_tick_begin();
+        error = sax_value(doc, data);
+        benchmark_tick_end();
+        if (error) return 0;
+    }
+    
+    return benchmark_tick_min();
+}
+
+/* Convert the lookup path to JSON Pointer, with '~' and '/' escaped. */
+static std::string lookup_pointer(const lookup_target *target) {
+    std::string ptr;
+    for (usize d = 0; d < target->depth; d++) {
+        ptr += '/';
+        for (const char *c = target->path[d]; *c; c++) {
+            if (*c == '~') ptr += "~0";
+            else if (*c == '/') ptr += "~1";
+            else ptr += *c;
+        }
+    }
+    return ptr;
+}
+
+u64 lookup_measure_simdjson_ondemand(const char *json, size_t size,
+                                     const lookup_target *targets, usize target_count,
+                                     usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    // On-Demand cannot keep an object across lookups, so the walk from the
+    // root to each object is measured, the structural index is built once
+    simdjson::padded_string padded(json, size);
+    simdjson::ondemand::parser parser;
+    simdjson::ondemand::document doc;
+    if (parser.iterate(padded).get(doc)) return 0;
+    std::vector<std::string> ptrs(target_count);
+    for (usize t = 0; t < target_count; t++) ptrs[t] = lookup_pointer(targets + t);
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        bool suc = true;
+        benchmark_tick_begin();
+        for (usize t = 0; t < target_count; t++) {
+            const lookup_target *target = targets + t;
+            simdjson::ondemand::object obj;
+            // at_pointer() rewinds the document
+            if (doc.at_pointer(ptrs[t]).get_object().get(obj)) {
+                suc = false;
+                break;
+            }
+            for (usize k = 0; k < target->key_count; k++) {
+                std::string_view key(target->keys[k], target->key_lens[k]);
+                num += obj.find_field_unordered(key).error() == simdjson::SUCCESS;
+            }
+        }
+        benchmark_tick_end();
+        if (!suc) return 0;
+        *found = num;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// utf8
+
+u64 utf8_measure_simdjson(const char *json, size_t size, bool validate, int repeat) {
+    benchmark_tick_init();
+    
+    // the validation is fused into the first stage, it cannot be turned off
+    if (!validate) return 0;
+    simdjson::dom::parser parser;
+    simdjson::dom::element root;
+    simdjson::error_code error;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        parser.parse(json, size).tie(root, error);
+        benchmark_tick_end();
+        if (error) return 0;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// string
+
+u64 string_reader_measure_simdjson(const char *json, size_t size, usize *len, int repeat) {
+    benchmark_tick_init();
+    
+    simdjson::dom::parser parser;
+    simdjson::dom::array arr;
+    for (int i = 0; i < repeat; i++) {
+        usize sum = 0;
+        benchmark_tick_begin();
+        simdjson::error_code error = parser.parse(json, size).get_array().get(arr);
+        if (!error) {
+            for (simdjson::dom::element val : arr) sum += val.get_string_length().value_unsafe();
+        }
+        benchmark_tick_end();
+        if (error) return 0;
+        *len = sum;
+    }
+    
+    return benchmark_tick_min();
+}
+
+u64 string_reader_measure_simdjson_ondemand(const char *json, size_t size, usize *len, int repeat) {
+    benchmark_tick_init();
+    
+    // the strings are unescaped on get_string()
+    simdjson::padded_string padded(json, size);
+    simdjson::ondemand::parser parser;
+    for (int i = 0; i < repeat; i++) {
+        usize sum = 0;
+        simdjson::ondemand::document doc;
+        simdjson::ondemand::array arr;
+        benchmark_tick_begin();
+        simdjson::error_code error = parser.iterate(padded).get(doc);
+        if (!error) error = doc.get_array().get(arr);
+        if (!error) {
+            for (auto val : arr) {
+                std::string_view str;
+                if ((error = val.get_string().get(str))) break;
+                sum += str.size();
+            }
+        }
+        if (!error && !doc.at_end()) error = simdjson::TRAILING_CONTENT;
+        benchmark_tick_end();
+        if (error) return 0;
+        *len = sum;
+    }
+    
+    return benchmark_tick_min();
+}
+
+u64 string_writer_measure_simdjson(const char *json, size_t size, string_escape esc,
+                                   size_t *out_size, int repeat) {
+    // minify writes only the required escapes
+    if (esc != STRING_ESCAPE_DEFAULT) return 0;
+    
+    benchmark_tick_init();
+    
+    simdjson::dom::parser parser;
+    simdjson::dom::element doc;
+    if (parser.parse(json, size).get(doc)) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        auto str = simdjson::minify(doc);
+        benchmark_tick_end();
+        if (str.length() == 0) return 0;
+        *out_size = str.length();
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// blob
+
+u64 blob_measure_simdjson(const char *json, size_t size, bool insitu,
+                          usize *mem, int repeat) {
+    // the strings are always copied into the string buffer of the parser,
+    // which is sized by the input capacity and not reported
+    if (insitu) return 0;
+    
+    bool valid;
+    u64 ticks = reader_measure_simdjson(json, size, &valid, repeat);
+    *mem = 0;
+    return valid ? ticks : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// nested
+
+u64 nested_measure_simdjson(const char *json, size_t size, nested_mode mode,
+                            usize *count, int repeat) {
+    // the input is never modified, the strings are copied into the parser
+    if (mode == NESTED_INSITU) return 0;
+    
+    benchmark_tick_init();
+    
+    simdjson::dom::parser parser, inner_parser;
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        simdjson::dom::array arr;
+        benchmark_tick_begin();
+        simdjson::error_code error = parser.parse(json, size).get_array().get(arr);
+        if (!error) {
+            for (simdjson::dom::element msg : arr) {
+                std::string_view str;
+                simdjson::dom::element inner;
+                if ((error = msg["payload"].get_string().get(str))) break;
+                if (mode == NESTED_COPY) {
+                    simdjson::padded_string tmp(str);
+                    error = inner_parser.parse(tmp).get(inner);
+                } else {
+                    // read in place, the string buffer of the outer doc is
+                    // allocated with SIMDJSON_PADDING bytes to spare
+                    error = inner_parser.parse(str.data(), str.size(), false).get(inner);
+                }
+                if (error) break;
+                num++;
+            }
+        }
+        benchmark_tick_end();
+        if (error) return 0;
+        *count = num;
+    }
+    
+    return benchmark_tick_min();
+}
+
+
 }
 #endif
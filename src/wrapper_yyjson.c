@@ -5,7 +5,8 @@
 // -----------------------------------------------------------------------------
 // reader
 
-u64 reader_measure_yyjson(const char *json, size_t size, int repeat) {
+u64 reader_measure_yyjson(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
     benchmark_tick_init();
     
     for (int i = 0; i < repeat; i++) {
@@ -16,10 +17,12 @@ u64 reader_measure_yyjson(const char *json, size_t size, int repeat) {
         yyjson_doc_free(doc);
     }
     
+    *valid = true;
     return benchmark_tick_min();
 }
 
-u64 reader_measure_yyjson_fast(const char *json, size_t size, int repeat) {
+u64 reader_measure_yyjson_fast(const char *json, size_t size, bool *valid, int repeat) {
+    *valid = false;
     benchmark_tick_init();
     
     yyjson_read_flag flag = YYJSON_READ_INSITU;
@@ -49,6 +52,7 @@ u64 reader_measure_yyjson_fast(const char *json, size_t size, int repeat) {
     free(buf);
     free(dat);
     
+    *valid = true;
     return benchmark_tick_min();
 }
 
@@ -199,3 +203,1206 @@ u64 stats_measure_yyjson_fast(const char *json, size_t size, stats_data *data, i
     
     return benchmark_tick_min();
 }
+
+
+// -----------------------------------------------------------------------------
+// parallel reader
+
+typedef struct {
+    const char *json;
+    usize *splits;
+    char **bufs;
+    yyjson_doc **docs;
+} parallel_reader_ctx;
+
+static void parallel_reader_task(void *ctx_ptr, int idx) {
+    parallel_reader_ctx *ctx = (parallel_reader_ctx *)ctx_ptr;
+    usize beg = ctx->splits[idx] + 1;
+    usize len = ctx->splits[idx + 1] - beg;
+    
+    // wrap the segment as an array and parse it insitu
+    char *buf = malloc(len + 2 + YYJSON_PADDING_SIZE);
+    ctx->bufs[idx] = buf;
+    ctx->docs[idx] = NULL;
+    if (!buf) return;
+    buf[0] = '[';
+    memcpy(buf + 1, ctx->json + beg, len);
+    buf[len + 1] = ']';
+    memset(buf + len + 2, 0, YYJSON_PADDING_SIZE);
+    ctx->docs[idx] = yyjson_read_opts(buf, len + 2, YYJSON_READ_INSITU, NULL, NULL);
+}
+
+u64 parallel_reader_measure_yyjson(const char *json, size_t size,
+                                   int thread_count, int repeat) {
+    benchmark_tick_init();
+    
+    // the serial baseline does the same copy and insitu read as a segment
+    if (thread_count <= 1) {
+        for (int i = 0; i < repeat; i++) {
+            benchmark_tick_begin();
+            char *buf = malloc(size + YYJSON_PADDING_SIZE);
+            yyjson_doc *doc = NULL;
+            if (buf) {
+                memcpy(buf, json, size);
+                memset(buf + size, 0, YYJSON_PADDING_SIZE);
+                doc = yyjson_read_opts(buf, size, YYJSON_READ_INSITU, NULL, NULL);
+            }
+            benchmark_tick_end();
+            yyjson_doc_free(doc);
+            free(buf);
+            if (!doc) return 0;
+        }
+        return benchmark_tick_min();
+    }
+    
+    // several segments per thread for load balancing
+    int seg_max = thread_count * 4;
+    yy_thread_pool *pool = yy_thread_pool_new(thread_count);
+    parallel_reader_ctx ctx;
+    ctx.json = json;
+    ctx.splits = malloc((seg_max + 1) * sizeof(usize));
+    ctx.bufs = calloc(seg_max, sizeof(char *));
+    ctx.docs = calloc(seg_max, sizeof(yyjson_doc *));
+    
+    bool suc = (pool != NULL);
+    for (int i = 0; i < repeat && suc; i++) {
+        benchmark_tick_begin();
+        int seg_num = json_array_split(json, size, ctx.splits, seg_max, pool);
+        if (seg_num) yy_thread_pool_run(pool, parallel_reader_task, &ctx, seg_num);
+        benchmark_tick_end();
+        
+        // the segment docs together should be same as the serial result
+        usize elem_num = 0;
+        if (!seg_num) suc = false;
+        for (int s = 0; s < seg_num; s++) {
+            if (!ctx.docs[s]) suc = false;
+            else elem_num += yyjson_arr_size(yyjson_doc_get_root(ctx.docs[s]));
+            yyjson_doc_free(ctx.docs[s]);
+            free(ctx.bufs[s]);
+            ctx.docs[s] = NULL;
+            ctx.bufs[s] = NULL;
+        }
+        if (i == 0 && suc) {
+            yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+            suc = doc && elem_num == yyjson_arr_size(yyjson_doc_get_root(doc));
+            yyjson_doc_free(doc);
+        }
+    }
+    
+    yy_thread_pool_free(pool);
+    free(ctx.splits);
+    free(ctx.bufs);
+    free(ctx.docs);
+    
+    return suc ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// parallel writer
+
+/**
+ Output buffer of a segment, reused across runs. It is also the allocator of
+ yyjson_val_write_opts(), so each child is written at the end of the segment.
+ */
+typedef struct {
+    char *buf;
+    usize cap;
+    usize used; /* bytes of the segment output */
+    usize last; /* offset of the block of the running write */
+} parallel_writer_arena;
+
+/** Iterator at the first child of a segment. */
+typedef union {
+    yyjson_arr_iter arr;
+    yyjson_obj_iter obj;
+} parallel_writer_iter;
+
+typedef struct {
+    bool is_obj;
+    parallel_writer_iter *iters; /* first child of each segment */
+    usize *counts;               /* value count (or pair count) of each segment */
+    parallel_writer_arena *arenas;
+    json_segment *segs;
+} parallel_writer_ctx;
+
+static bool parallel_writer_reserve(parallel_writer_arena *arena, usize size) {
+    if (size <= arena->cap) return true;
+    usize cap = arena->cap * 2;
+    if (cap < size) cap = size;
+    if (cap < 4096) cap = 4096;
+    char *buf = realloc(arena->buf, cap);
+    if (!buf) return false;
+    arena->buf = buf;
+    arena->cap = cap;
+    return true;
+}
+
+static void *parallel_writer_malloc(void *ctx, size_t size) {
+    parallel_writer_arena *arena = (parallel_writer_arena *)ctx;
+    usize ofs = (arena->used + 15) & ~(usize)15; // the writer keeps its stack in the block
+    if (!parallel_writer_reserve(arena, ofs + size)) return NULL;
+    arena->last = ofs;
+    return arena->buf + ofs;
+}
+
+static void *parallel_writer_realloc(void *ctx, void *ptr, size_t old_size, size_t size) {
+    parallel_writer_arena *arena = (parallel_writer_arena *)ctx;
+    (void)old_size;
+    // the writer only grows the block of the running write, which is the last one
+    if ((char *)ptr != arena->buf + arena->last) return NULL;
+    if (!parallel_writer_reserve(arena, arena->last + size)) return NULL;
+    return arena->buf + arena->last;
+}
+
+static void parallel_writer_free(void *ctx, void *ptr) {
+    // the block is reused by the next write
+    (void)ctx;
+    (void)ptr;
+}
+
+static bool parallel_writer_append(parallel_writer_arena *arena, char c) {
+    if (!parallel_writer_reserve(arena, arena->used + 1)) return false;
+    arena->buf[arena->used++] = c;
+    return true;
+}
+
+static bool parallel_writer_append_val(parallel_writer_arena *arena, const yyjson_alc *alc,
+                                       yyjson_val *val) {
+    usize len;
+    char *str = yyjson_val_write_opts(val, YYJSON_WRITE_NOFLAG, alc, &len, NULL);
+    if (!str) return false;
+    // the block was aligned, move the output back by less than 16 bytes
+    memmove(arena->buf + arena->used, str, len);
+    arena->used += len;
+    return true;
+}
+
+static void parallel_writer_task(void *ctx_ptr, int idx) {
+    parallel_writer_ctx *ctx = (parallel_writer_ctx *)ctx_ptr;
+    parallel_writer_arena *arena = ctx->arenas + idx;
+    yyjson_alc alc = { parallel_writer_malloc, parallel_writer_realloc,
+                       parallel_writer_free, arena };
+    
+    // the first segment leaves room for the bracket, it is joined in place
+    usize head = (idx == 0);
+    parallel_writer_iter iter = ctx->iters[idx];
+    arena->used = head;
+    bool suc = parallel_writer_reserve(arena, head);
+    for (usize n = 0; n < ctx->counts[idx] && suc; n++) {
+        if (n > 0) suc = parallel_writer_append(arena, ',');
+        if (ctx->is_obj) {
+            yyjson_val *key = yyjson_obj_iter_next(&iter.obj);
+            suc = suc && parallel_writer_append_val(arena, &alc, key);
+            suc = suc && parallel_writer_append(arena, ':');
+            suc = suc && parallel_writer_append_val(arena, &alc, yyjson_obj_iter_get_val(key));
+        } else {
+            suc = suc && parallel_writer_append_val(arena, &alc, yyjson_arr_iter_next(&iter.arr));
+        }
+    }
+    ctx->segs[idx].str = suc ? arena->buf + head : NULL;
+    ctx->segs[idx].len = suc ? arena->used - head : 0;
+}
+
+static u64 parallel_writer_measure(const char *json, size_t size, size_t *out_size,
+                                   int thread_count, int repeat, bool join) {
+    benchmark_tick_init();
+    
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    if (!yyjson_is_ctn(root)) {
+        yyjson_doc_free(doc);
+        return 0;
+    }
+    usize expect_len;
+    char *expect = yyjson_write(doc, YYJSON_WRITE_NOFLAG, &expect_len);
+    if (!expect) {
+        yyjson_doc_free(doc);
+        return 0;
+    }
+    
+    if (thread_count <= 1) {
+        bool suc = true;
+        for (int i = 0; i < repeat && suc; i++) {
+            benchmark_tick_begin();
+            char *str = yyjson_write(doc, YYJSON_WRITE_NOFLAG, out_size);
+            benchmark_tick_end();
+            suc = (str != NULL);
+            free(str);
+        }
+        free(expect);
+        yyjson_doc_free(doc);
+        return suc ? benchmark_tick_min() : 0;
+    }
+    
+    // several segments per thread for load balancing
+    bool is_obj = yyjson_is_obj(root);
+    usize child_num = is_obj ? yyjson_obj_size(root) : yyjson_arr_size(root);
+    int seg_num = thread_count * 4;
+    if ((usize)seg_num > child_num) seg_num = (int)child_num;
+    if (seg_num < 1) seg_num = 1;
+    yy_thread_pool *pool = yy_thread_pool_new(thread_count);
+    parallel_writer_ctx ctx;
+    ctx.is_obj = is_obj;
+    ctx.iters = malloc(seg_num * sizeof(parallel_writer_iter));
+    ctx.counts = malloc(seg_num * sizeof(usize));
+    ctx.arenas = calloc(seg_num, sizeof(parallel_writer_arena));
+    ctx.segs = malloc(seg_num * sizeof(json_segment));
+    bool suc = pool && ctx.iters && ctx.counts && ctx.arenas && ctx.segs;
+    
+    // partition the children of root, the document does not change between runs
+    if (suc) {
+        parallel_writer_iter iter;
+        if (is_obj) yyjson_obj_iter_init(root, &iter.obj);
+        else yyjson_arr_iter_init(root, &iter.arr);
+        usize child_idx = 0;
+        for (int s = 0; s < seg_num; s++) {
+            usize end_idx = child_num * (usize)(s + 1) / (usize)seg_num;
+            ctx.iters[s] = iter;
+            ctx.counts[s] = end_idx - child_idx;
+            for (; child_idx < end_idx; child_idx++) {
+                if (is_obj) yyjson_obj_iter_next(&iter.obj);
+                else yyjson_arr_iter_next(&iter.arr);
+            }
+        }
+    }
+    
+    for (int i = 0; i < repeat && suc; i++) {
+        benchmark_tick_begin();
+        
+        // write segments, then join them after the first one or leave them as
+        // an iovec list
+        yy_thread_pool_run(pool, parallel_writer_task, &ctx, seg_num);
+        for (int s = 0; s < seg_num; s++) {
+            if (!ctx.segs[s].str) suc = false;
+        }
+        char *str = NULL;
+        if (suc) {
+            usize join_size = json_segments_join_size(ctx.segs, seg_num);
+            if (!join) {
+                *out_size = join_size - 1;
+            } else if (parallel_writer_reserve(&ctx.arenas[0], join_size)) {
+                str = ctx.arenas[0].buf;
+                ctx.segs[0].str = str + 1;
+                *out_size = json_segments_join(ctx.segs, seg_num, is_obj, str, pool);
+                suc = (*out_size != 0);
+            } else {
+                suc = false;
+            }
+        }
+        benchmark_tick_end();
+        
+        if (i == 0 && suc) {
+            if (join) {
+                suc = (*out_size == expect_len && memcmp(str, expect, expect_len) == 0);
+            } else {
+                // the iovec list should be the same output after a join
+                char *tmp = malloc(*out_size + 1);
+                suc = tmp && json_segments_join(ctx.segs, seg_num, is_obj, tmp, pool) == expect_len &&
+                      memcmp(tmp, expect, expect_len) == 0;
+                free(tmp);
+            }
+        }
+    }
+    
+    yy_thread_pool_free(pool);
+    for (int s = 0; s < seg_num && ctx.arenas; s++) free(ctx.arenas[s].buf);
+    free(ctx.iters);
+    free(ctx.counts);
+    free(ctx.arenas);
+    free(ctx.segs);
+    free(expect);
+    yyjson_doc_free(doc);
+    
+    return suc ? benchmark_tick_min() : 0;
+}
+
+u64 parallel_writer_measure_yyjson(const char *json, size_t size, size_t *out_size,
+                                   int thread_count, int repeat) {
+    return parallel_writer_measure(json, size, out_size, thread_count, repeat, true);
+}
+
+u64 parallel_writer_measure_yyjson_iov(const char *json, size_t size, size_t *out_size,
+                                       int thread_count, int repeat) {
+    return parallel_writer_measure(json, size, out_size, thread_count, repeat, false);
+}
+
+
+// -----------------------------------------------------------------------------
+// number reader
+
+u64 number_reader_measure_yyjson(const number_data *data, f64 *vals,
+                                 bool single, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        if (single) {
+            benchmark_tick_begin();
+            for (usize n = 0; n < data->count; n++) {
+                yyjson_doc *doc = yyjson_read(data->strs[n], data->lens[n], YYJSON_READ_NOFLAG);
+                yyjson_val *val = yyjson_doc_get_root(doc);
+                vals[n] = yyjson_is_num(val) ? yyjson_get_num(val) : NAN;
+                yyjson_doc_free(doc);
+            }
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            yyjson_doc *doc = yyjson_read(data->array, data->array_size, YYJSON_READ_NOFLAG);
+            yyjson_val *root = yyjson_doc_get_root(doc);
+            usize idx, max;
+            yyjson_val *val;
+            yyjson_arr_foreach(root, idx, max, val) {
+                vals[idx] = yyjson_get_num(val);
+            }
+            benchmark_tick_end();
+            if (!doc) return 0;
+            yyjson_doc_free(doc);
+        }
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// number writer
+
+u64 number_writer_measure_yyjson(const number_values *vals, char **out,
+                                 usize *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    yyjson_mut_doc *doc = yyjson_mut_doc_new(NULL);
+    yyjson_mut_val *arr = yyjson_mut_arr(doc);
+    yyjson_mut_doc_set_root(doc, arr);
+    for (usize n = 0; n < vals->count; n++) {
+        if (vals->is_int) yyjson_mut_arr_add_sint(doc, arr, vals->ints[n]);
+        else yyjson_mut_arr_add_real(doc, arr, vals->reals[n]);
+    }
+    
+    char *str = NULL;
+    for (int i = 0; i < repeat; i++) {
+        free(str);
+        benchmark_tick_begin();
+        str = yyjson_mut_write(doc, YYJSON_WRITE_NOFLAG, out_size);
+        benchmark_tick_end();
+        if (!str) break;
+    }
+    yyjson_mut_doc_free(doc);
+    
+    *out = str;
+    return str ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// roundtrip
+
+u64 roundtrip_measure_yyjson(const char *json, size_t size, size_t *out_size,
+                             bool *roundtrip, int repeat) {
+    benchmark_tick_init();
+    
+    *roundtrip = true;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+        char *str = yyjson_write(doc, YYJSON_WRITE_NOFLAG, out_size);
+        yyjson_doc_free(doc);
+        benchmark_tick_end();
+        if (!str) return 0;
+        if (*out_size != size || memcmp(json, str, size) != 0) *roundtrip = false;
+        free(str);
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// lookup
+
+static yyjson_val *lookup_resolve(yyjson_val *val, const lookup_target *target) {
+    for (usize d = 0; d < target->depth && val; d++) {
+        if (yyjson_is_arr(val)) {
+            val = yyjson_arr_get(val, (usize)strtoull(target->path[d], NULL, 10));
+        } else {
+            val = yyjson_obj_get(val, target->path[d]);
+        }
+    }
+    return val;
+}
+
+u64 lookup_measure_yyjson(const char *json, size_t size,
+                          const lookup_target *targets, usize target_count,
+                          usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return 0;
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    yyjson_val **objs = malloc((target_count + 1) * sizeof(yyjson_val *));
+    bool suc = true;
+    for (usize t = 0; t < target_count; t++) {
+        objs[t] = lookup_resolve(root, targets + t);
+        if (!yyjson_is_obj(objs[t])) suc = false;
+    }
+    
+    for (int i = 0; i < repeat && suc; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize t = 0; t < target_count; t++) {
+            const lookup_target *target = targets + t;
+            for (usize k = 0; k < target->key_count; k++) {
+                num += yyjson_obj_getn(objs[t], target->keys[k], target->key_lens[k]) != NULL;
+            }
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    free(objs);
+    yyjson_doc_free(doc);
+    return suc ? benchmark_tick_min() : 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// pointer
+
+static yy_inline yyjson_val *pointer_walk(yyjson_val *val, const json_ptr_token *tokens,
+                                          usize count) {
+    for (usize t = 0; t < count && val; t++) {
+        usize idx;
+        if (yyjson_is_obj(val)) {
+            val = yyjson_obj_getn(val, tokens[t].str, tokens[t].len);
+        } else if (yyjson_is_arr(val) && json_pointer_token_to_index(tokens + t, &idx)) {
+            val = yyjson_arr_get(val, idx);
+        } else {
+            val = NULL;
+        }
+    }
+    return val;
+}
+
+u64 pointer_measure_yyjson(const char *json, size_t size, const pointer_data *data,
+                           bool walk_only, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return 0;
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        if (walk_only) {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                num += pointer_walk(root, data->tokens[p], data->token_counts[p]) != NULL;
+            }
+            benchmark_tick_end();
+        } else {
+            benchmark_tick_begin();
+            for (usize p = 0; p < data->count; p++) {
+                num += yyjson_doc_ptr_getn(doc, data->ptrs[p], data->lens[p]) != NULL;
+            }
+            benchmark_tick_end();
+        }
+        *found = num;
+    }
+    
+    yyjson_doc_free(doc);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// path
+
+static json_path_type path_get_type(json_path_val val) {
+    switch (yyjson_get_type((yyjson_val *)val.ptr)) {
+        case YYJSON_TYPE_NULL: return JSON_PATH_NULL;
+        case YYJSON_TYPE_BOOL: return JSON_PATH_BOOL;
+        case YYJSON_TYPE_NUM: return JSON_PATH_NUM;
+        case YYJSON_TYPE_STR: return JSON_PATH_STR;
+        case YYJSON_TYPE_ARR: return JSON_PATH_ARR;
+        case YYJSON_TYPE_OBJ: return JSON_PATH_OBJ;
+        default: return JSON_PATH_NONE;
+    }
+}
+
+static bool path_get_bool(json_path_val val) {
+    return yyjson_get_bool((yyjson_val *)val.ptr);
+}
+
+static f64 path_get_num(json_path_val val) {
+    return yyjson_get_num((yyjson_val *)val.ptr);
+}
+
+static const char *path_get_str(json_path_val val, usize *len) {
+    *len = yyjson_get_len((yyjson_val *)val.ptr);
+    return yyjson_get_str((yyjson_val *)val.ptr);
+}
+
+static usize path_arr_size(json_path_val val) {
+    return yyjson_arr_size((yyjson_val *)val.ptr);
+}
+
+static bool path_arr_get(json_path_val val, usize idx, json_path_val *out) {
+    out->ptr = yyjson_arr_get((yyjson_val *)val.ptr, idx);
+    return out->ptr != NULL;
+}
+
+static bool path_obj_get(json_path_val val, const char *key, usize key_len,
+                         json_path_val *out) {
+    out->ptr = yyjson_obj_getn((yyjson_val *)val.ptr, key, key_len);
+    return out->ptr != NULL;
+}
+
+static void path_foreach(json_path_val val, json_path_each_func func, void *ctx) {
+    yyjson_val *ctn = (yyjson_val *)val.ptr, *k, *v;
+    json_path_val sub = { NULL, 0 };
+    usize idx, max;
+    if (yyjson_is_obj(ctn)) {
+        yyjson_obj_foreach(ctn, idx, max, k, v) {
+            sub.ptr = v;
+            func(ctx, yyjson_get_str(k), yyjson_get_len(k), sub);
+        }
+    } else {
+        yyjson_arr_foreach(ctn, idx, max, v) {
+            sub.ptr = v;
+            func(ctx, NULL, 0, sub);
+        }
+    }
+}
+
+static const json_path_adapter path_adapter = {
+    path_get_type, path_get_bool, path_get_num, path_get_str,
+    path_arr_size, path_arr_get, path_obj_get, path_foreach
+};
+
+u64 path_measure_yyjson(const char *json, size_t size, const json_path *path,
+                        bool with_parse, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return 0;
+    json_path_val root = { NULL, 0 };
+    
+    for (int i = 0; i < repeat; i++) {
+        if (with_parse) {
+            benchmark_tick_begin();
+            yyjson_doc *tmp = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+            root.ptr = yyjson_doc_get_root(tmp);
+            if (tmp) *found = json_path_eval(path, &path_adapter, root);
+            yyjson_doc_free(tmp);
+            benchmark_tick_end();
+            if (!tmp) {
+                yyjson_doc_free(doc);
+                return 0;
+            }
+        } else {
+            root.ptr = yyjson_doc_get_root(doc);
+            benchmark_tick_begin();
+            *found = json_path_eval(path, &path_adapter, root);
+            benchmark_tick_end();
+        }
+    }
+    
+    yyjson_doc_free(doc);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// index
+
+u64 index_measure_yyjson(const char *json, size_t size, const usize *idxs,
+                         usize idx_count, usize *found, int repeat) {
+    benchmark_tick_init();
+    
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return 0;
+    yyjson_val *arr = yyjson_doc_get_root(doc);
+    
+    for (int i = 0; i < repeat; i++) {
+        usize num = 0;
+        benchmark_tick_begin();
+        for (usize n = 0; n < idx_count; n++) {
+            num += yyjson_arr_get(arr, idxs[n]) != NULL;
+        }
+        benchmark_tick_end();
+        *found = num;
+    }
+    
+    yyjson_doc_free(doc);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// mutate
+
+#define MUTATE_KEY_MAX 256
+
+static void mutate_val(yyjson_mut_doc *doc, yyjson_mut_val *val, usize *ops) {
+    usize idx, max, n;
+    yyjson_mut_val *k, *v;
+    if (yyjson_mut_is_obj(val)) {
+        yyjson_mut_val *first = NULL, *mid = NULL, *last = NULL;
+        n = yyjson_mut_obj_size(val);
+        yyjson_mut_obj_foreach(val, idx, max, k, v) {
+            if (idx == 0) first = k;
+            if (idx == n / 2) mid = k;
+            last = k;
+            mutate_val(doc, v, ops);
+        }
+        if (n >= 1) {
+            yyjson_mut_obj_replace(val, last, yyjson_mut_sint(doc, (i64)n));
+            (*ops)++;
+        }
+        if (n >= 3) {
+            yyjson_mut_obj_remove(val, mid);
+            (*ops)++;
+        }
+        if (n >= 1) {
+            char buf[MUTATE_KEY_MAX];
+            usize len = yyjson_mut_get_len(first);
+            if (len > MUTATE_KEY_MAX - 2) len = MUTATE_KEY_MAX - 2;
+            buf[0] = '_';
+            memcpy(buf + 1, yyjson_mut_get_str(first), len);
+            buf[len + 1] = '\0';
+            yyjson_mut_obj_rename_keyn(doc, val, yyjson_mut_get_str(first),
+                                       yyjson_mut_get_len(first), buf, len + 1);
+            (*ops)++;
+        }
+        yyjson_mut_obj_add_sint(doc, val, "_id", (i64)n);
+        (*ops)++;
+    } else if (yyjson_mut_is_arr(val)) {
+        n = yyjson_mut_arr_size(val);
+        yyjson_mut_arr_foreach(val, idx, max, v) {
+            mutate_val(doc, v, ops);
+        }
+        yyjson_mut_arr_add_sint(doc, val, (i64)n);
+        (*ops)++;
+        if (n >= 2) {
+            yyjson_mut_arr_remove_range(val, n / 4, n / 2 - n / 4);
+            yyjson_mut_arr_insert(val, yyjson_mut_str(doc, "spliced"), 0);
+            (*ops)++;
+        }
+    } else if (yyjson_mut_is_real(val)) {
+        yyjson_mut_set_real(val, yyjson_mut_get_real(val) + 1);
+        (*ops)++;
+    } else if (yyjson_mut_is_uint(val)) {
+        yyjson_mut_set_uint(val, yyjson_mut_get_uint(val) + 1);
+        (*ops)++;
+    } else if (yyjson_mut_is_sint(val)) {
+        yyjson_mut_set_sint(val, yyjson_mut_get_sint(val) + 1);
+        (*ops)++;
+    } else if (yyjson_mut_is_bool(val)) {
+        yyjson_mut_set_bool(val, !yyjson_mut_get_bool(val));
+        (*ops)++;
+    }
+}
+
+u64 mutate_measure_yyjson(const char *json, size_t size, bool write,
+                          usize *ops, size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        yyjson_doc *idoc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+        yyjson_mut_doc *doc = yyjson_doc_mut_copy(idoc, NULL);
+        yyjson_doc_free(idoc);
+        if (!doc) return 0;
+        
+        usize num = 0;
+        char *str = NULL;
+        if (!write) {
+            benchmark_tick_begin();
+            mutate_val(doc, yyjson_mut_doc_get_root(doc), &num);
+            benchmark_tick_end();
+        } else {
+            mutate_val(doc, yyjson_mut_doc_get_root(doc), &num);
+            benchmark_tick_begin();
+            str = yyjson_mut_write(doc, YYJSON_WRITE_NOFLAG, out_size);
+            benchmark_tick_end();
+            if (!str) {
+                yyjson_mut_doc_free(doc);
+                return 0;
+            }
+            free(str);
+        }
+        *ops = num;
+        yyjson_mut_doc_free(doc);
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// patch
+
+u64 patch_measure_yyjson(const char *json, size_t size, const char *patch,
+                         size_t patch_size, bool merge, int repeat) {
+    benchmark_tick_init();
+    
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    yyjson_doc *pdoc = yyjson_read(patch, patch_size, YYJSON_READ_NOFLAG);
+    if (!doc || !pdoc) {
+        yyjson_doc_free(doc);
+        yyjson_doc_free(pdoc);
+        return 0;
+    }
+    yyjson_val *orig = yyjson_doc_get_root(doc);
+    yyjson_val *ops = yyjson_doc_get_root(pdoc);
+    
+    for (int i = 0; i < repeat; i++) {
+        yyjson_mut_val *root;
+        benchmark_tick_begin();
+        yyjson_mut_doc *mdoc = yyjson_mut_doc_new(NULL);
+        if (merge) root = yyjson_merge_patch(mdoc, orig, ops);
+        else root = yyjson_patch(mdoc, orig, ops, NULL);
+        yyjson_mut_doc_set_root(mdoc, root);
+        benchmark_tick_end();
+        yyjson_mut_doc_free(mdoc);
+        if (!root) {
+            yyjson_doc_free(doc);
+            yyjson_doc_free(pdoc);
+            return 0;
+        }
+    }
+    
+    yyjson_doc_free(doc);
+    yyjson_doc_free(pdoc);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// build
+
+static yy_inline yyjson_mut_val *build_str_val(yyjson_mut_doc *doc, build_str str, bool copy) {
+    if (!str.str) return yyjson_mut_null(doc);
+    if (copy) return yyjson_mut_strncpy(doc, str.str, str.len);
+    return yyjson_mut_strn(doc, str.str, str.len);
+}
+
+static yy_inline void build_add_str(yyjson_mut_doc *doc, yyjson_mut_val *obj,
+                                    const char *key, build_str str, bool copy) {
+    yyjson_mut_obj_add_val(doc, obj, key, build_str_val(doc, str, copy));
+}
+
+static yy_inline void build_add_id(yyjson_mut_doc *doc, yyjson_mut_val *obj,
+                                   const char *key, u64 id) {
+    if (id) yyjson_mut_obj_add_uint(doc, obj, key, id);
+    else yyjson_mut_obj_add_null(doc, obj, key);
+}
+
+static yy_inline void build_add_uints(yyjson_mut_doc *doc, yyjson_mut_val *obj,
+                                      const char *key, const u64 *vals, usize count) {
+    yyjson_mut_val *arr = yyjson_mut_obj_add_arr(doc, obj, key);
+    for (usize i = 0; i < count; i++) yyjson_mut_arr_add_uint(doc, arr, vals[i]);
+}
+
+static yyjson_mut_val *build_twitter_doc(yyjson_mut_doc *doc, const build_twitter *tw, bool copy) {
+    yyjson_mut_val *root = yyjson_mut_obj(doc);
+    yyjson_mut_val *statuses = yyjson_mut_obj_add_arr(doc, root, "statuses");
+    for (usize i = 0; i < tw->status_count; i++) {
+        const build_status *s = tw->statuses + i;
+        const build_user *u = &s->user;
+        yyjson_mut_val *st = yyjson_mut_arr_add_obj(doc, statuses);
+        build_add_str(doc, st, "created_at", s->created_at, copy);
+        yyjson_mut_obj_add_uint(doc, st, "id", s->id);
+        build_add_str(doc, st, "id_str", s->id_str, copy);
+        build_add_str(doc, st, "text", s->text, copy);
+        build_add_str(doc, st, "source", s->source, copy);
+        yyjson_mut_obj_add_bool(doc, st, "truncated", s->truncated);
+        build_add_id(doc, st, "in_reply_to_status_id", s->in_reply_to_status_id);
+        build_add_str(doc, st, "in_reply_to_status_id_str", s->in_reply_to_status_id_str, copy);
+        build_add_id(doc, st, "in_reply_to_user_id", s->in_reply_to_user_id);
+        build_add_str(doc, st, "in_reply_to_user_id_str", s->in_reply_to_user_id_str, copy);
+        build_add_str(doc, st, "in_reply_to_screen_name", s->in_reply_to_screen_name, copy);
+        
+        yyjson_mut_val *user = yyjson_mut_obj_add_obj(doc, st, "user");
+        yyjson_mut_obj_add_uint(doc, user, "id", u->id);
+        build_add_str(doc, user, "id_str", u->id_str, copy);
+        build_add_str(doc, user, "name", u->name, copy);
+        build_add_str(doc, user, "screen_name", u->screen_name, copy);
+        build_add_str(doc, user, "location", u->location, copy);
+        build_add_str(doc, user, "description", u->description, copy);
+        yyjson_mut_obj_add_bool(doc, user, "protected", u->is_protected);
+        yyjson_mut_obj_add_uint(doc, user, "followers_count", u->followers_count);
+        yyjson_mut_obj_add_uint(doc, user, "friends_count", u->friends_count);
+        yyjson_mut_obj_add_uint(doc, user, "listed_count", u->listed_count);
+        build_add_str(doc, user, "created_at", u->created_at, copy);
+        yyjson_mut_obj_add_uint(doc, user, "favourites_count", u->favourites_count);
+        yyjson_mut_obj_add_bool(doc, user, "verified", u->verified);
+        yyjson_mut_obj_add_uint(doc, user, "statuses_count", u->statuses_count);
+        build_add_str(doc, user, "lang", u->lang, copy);
+        build_add_str(doc, user, "profile_image_url", u->profile_image_url, copy);
+        
+        yyjson_mut_obj_add_uint(doc, st, "retweet_count", s->retweet_count);
+        yyjson_mut_obj_add_uint(doc, st, "favorite_count", s->favorite_count);
+        
+        yyjson_mut_val *ent = yyjson_mut_obj_add_obj(doc, st, "entities");
+        yyjson_mut_val *tags = yyjson_mut_obj_add_arr(doc, ent, "hashtags");
+        for (usize t = 0; t < s->hashtag_count; t++) {
+            yyjson_mut_val *tag = yyjson_mut_arr_add_obj(doc, tags);
+            build_add_str(doc, tag, "text", s->hashtags[t].text, copy);
+            build_add_uints(doc, tag, "indices", s->hashtags[t].indices, 2);
+        }
+        yyjson_mut_val *mens = yyjson_mut_obj_add_arr(doc, ent, "user_mentions");
+        for (usize m = 0; m < s->mention_count; m++) {
+            const build_mention *mention = s->mentions + m;
+            yyjson_mut_val *men = yyjson_mut_arr_add_obj(doc, mens);
+            build_add_str(doc, men, "screen_name", mention->screen_name, copy);
+            build_add_str(doc, men, "name", mention->name, copy);
+            yyjson_mut_obj_add_uint(doc, men, "id", mention->id);
+            build_add_str(doc, men, "id_str", mention->id_str, copy);
+            build_add_uints(doc, men, "indices", mention->indices, 2);
+        }
+        
+        yyjson_mut_obj_add_bool(doc, st, "favorited", s->favorited);
+        yyjson_mut_obj_add_bool(doc, st, "retweeted", s->retweeted);
+        build_add_str(doc, st, "lang", s->lang, copy);
+    }
+    
+    yyjson_mut_val *meta = yyjson_mut_obj_add_obj(doc, root, "search_metadata");
+    yyjson_mut_obj_add_real(doc, meta, "completed_in", tw->completed_in);
+    yyjson_mut_obj_add_uint(doc, meta, "max_id", tw->max_id);
+    build_add_str(doc, meta, "max_id_str", tw->max_id_str, copy);
+    build_add_str(doc, meta, "next_results", tw->next_results, copy);
+    build_add_str(doc, meta, "query", tw->query, copy);
+    build_add_str(doc, meta, "refresh_url", tw->refresh_url, copy);
+    yyjson_mut_obj_add_uint(doc, meta, "count", tw->count);
+    yyjson_mut_obj_add_uint(doc, meta, "since_id", tw->since_id);
+    build_add_str(doc, meta, "since_id_str", tw->since_id_str, copy);
+    return root;
+}
+
+static yyjson_mut_val *build_citm_doc(yyjson_mut_doc *doc, const build_citm *citm, bool copy) {
+    yyjson_mut_val *root = yyjson_mut_obj(doc);
+    yyjson_mut_val *events = yyjson_mut_obj_add_obj(doc, root, "events");
+    for (usize i = 0; i < citm->event_count; i++) {
+        const build_event *e = citm->events + i;
+        yyjson_mut_val *evt = yyjson_mut_obj(doc);
+        yyjson_mut_obj_add(events, build_str_val(doc, e->key, copy), evt);
+        yyjson_mut_obj_add_null(doc, evt, "description");
+        yyjson_mut_obj_add_uint(doc, evt, "id", e->id);
+        build_add_str(doc, evt, "logo", e->logo, copy);
+        build_add_str(doc, evt, "name", e->name, copy);
+        build_add_uints(doc, evt, "subTopicIds", e->sub_topic_ids, e->sub_topic_count);
+        yyjson_mut_obj_add_null(doc, evt, "subjectCode");
+        yyjson_mut_obj_add_null(doc, evt, "subtitle");
+        build_add_uints(doc, evt, "topicIds", e->topic_ids, e->topic_count);
+    }
+    
+    yyjson_mut_val *perfs = yyjson_mut_obj_add_arr(doc, root, "performances");
+    for (usize i = 0; i < citm->performance_count; i++) {
+        const build_performance *p = citm->performances + i;
+        yyjson_mut_val *perf = yyjson_mut_arr_add_obj(doc, perfs);
+        yyjson_mut_obj_add_uint(doc, perf, "eventId", p->event_id);
+        yyjson_mut_obj_add_uint(doc, perf, "id", p->id);
+        build_add_str(doc, perf, "logo", p->logo, copy);
+        yyjson_mut_obj_add_null(doc, perf, "name");
+        yyjson_mut_val *prices = yyjson_mut_obj_add_arr(doc, perf, "prices");
+        for (usize n = 0; n < p->price_count; n++) {
+            yyjson_mut_val *price = yyjson_mut_arr_add_obj(doc, prices);
+            yyjson_mut_obj_add_uint(doc, price, "amount", p->prices[n].amount);
+            yyjson_mut_obj_add_uint(doc, price, "audienceSubCategoryId",
+                                    p->prices[n].audience_sub_category_id);
+            yyjson_mut_obj_add_uint(doc, price, "seatCategoryId", p->prices[n].seat_category_id);
+        }
+        yyjson_mut_val *cats = yyjson_mut_obj_add_arr(doc, perf, "seatCategories");
+        for (usize n = 0; n < p->seat_category_count; n++) {
+            const build_seat_category *c = p->seat_categories + n;
+            yyjson_mut_val *cat = yyjson_mut_arr_add_obj(doc, cats);
+            yyjson_mut_val *areas = yyjson_mut_obj_add_arr(doc, cat, "areas");
+            for (usize a = 0; a < c->area_count; a++) {
+                yyjson_mut_val *area = yyjson_mut_arr_add_obj(doc, areas);
+                yyjson_mut_obj_add_uint(doc, area, "areaId", c->area_ids[a]);
+                yyjson_mut_obj_add_arr(doc, area, "blockIds");
+            }
+            yyjson_mut_obj_add_uint(doc, cat, "seatCategoryId", c->seat_category_id);
+        }
+        yyjson_mut_obj_add_null(doc, perf, "seatMapImage");
+        yyjson_mut_obj_add_uint(doc, perf, "start", p->start);
+        build_add_str(doc, perf, "venueCode", p->venue_code, copy);
+    }
+    
+    for (usize m = 0; m < citm->map_count; m++) {
+        const build_name_map *map = citm->maps + m;
+        yyjson_mut_val *obj = yyjson_mut_obj_add_obj(doc, root, map->name.str);
+        for (usize n = 0; n < map->count; n++) {
+            yyjson_mut_obj_add(obj, build_str_val(doc, map->names[n].key, copy),
+                               build_str_val(doc, map->names[n].name, copy));
+        }
+    }
+    return root;
+}
+
+u64 build_measure_yyjson(const build_data *data, bool copy, bool write,
+                         size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        char *str = NULL;
+        benchmark_tick_begin();
+        yyjson_mut_doc *doc = yyjson_mut_doc_new(NULL);
+        if (data->twitter) yyjson_mut_doc_set_root(doc, build_twitter_doc(doc, data->twitter, copy));
+        else yyjson_mut_doc_set_root(doc, build_citm_doc(doc, data->citm, copy));
+        if (write) str = yyjson_mut_write(doc, YYJSON_WRITE_NOFLAG, out_size);
+        benchmark_tick_end();
+        yyjson_mut_doc_free(doc);
+        if (write && !str) return 0;
+        free(str);
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// sax
+
+static void sax_iter(yyjson_val *val, stats_data *data) {
+    if (yyjson_is_arr(val)) {
+        data->num_array++;
+        yyjson_arr_iter iter = yyjson_arr_iter_with(val);
+        yyjson_val *tmp;
+        while ((tmp = yyjson_arr_iter_next(&iter))) {
+            if (yyjson_is_ctn(tmp)) sax_iter(tmp, data);
+            else stats_single(tmp, data);
+        }
+    } else if (yyjson_is_obj(val)) {
+        data->num_object++;
+        yyjson_obj_iter iter = yyjson_obj_iter_with(val);
+        yyjson_val *key;
+        while ((key = yyjson_obj_iter_next(&iter))) {
+            yyjson_val *tmp = yyjson_obj_iter_get_val(key);
+            data->num_string++;
+            if (yyjson_is_ctn(tmp)) sax_iter(tmp, data);
+            else stats_single(tmp, data);
+        }
+    } else {
+        stats_single(val, data);
+    }
+}
+
+u64 sax_measure_yyjson(const char *json, size_t size, stats_data *data, int repeat) {
+    benchmark_tick_init();
+    
+    // yyjson has no event API, parse into a reused pool and iterate once
+    usize buf_size = yyjson_read_max_memory_usage(size, YYJSON_READ_NOFLAG);
+    void *buf = malloc(buf_size);
+    yyjson_alc alc;
+    yyjson_alc_pool_init(&alc, buf, buf_size);
+    
+    for (int i = 0; i < repeat; i++) {
+        memset(data, 0, sizeof(stats_data));
+        benchmark_tick_begin();
+        yyjson_doc *doc = yyjson_read_opts((char *)json, size, YYJSON_READ_NOFLAG, &alc, NULL);
+        if (doc) sax_iter(yyjson_doc_get_root(doc), data);
+        benchmark_tick_end();
+        if (!doc) {
+            free(buf);
+            return 0;
+        }
+        yyjson_doc_free(doc);
+    }
+    
+    free(buf);
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// utf8
+
+u64 utf8_measure_yyjson(const char *json, size_t size, bool validate, int repeat) {
+    benchmark_tick_init();
+    
+    // invalid sequences are copied into the strings as is, without checking
+    yyjson_read_flag flag = validate ? YYJSON_READ_NOFLAG : YYJSON_READ_ALLOW_INVALID_UNICODE;
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        yyjson_doc *doc = yyjson_read(json, size, flag);
+        benchmark_tick_end();
+        if (!doc) return 0;
+        yyjson_doc_free(doc);
+    }
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// string
+
+u64 string_reader_measure_yyjson(const char *json, size_t size, usize *len, int repeat) {
+    benchmark_tick_init();
+    
+    for (int i = 0; i < repeat; i++) {
+        usize sum = 0, idx, max;
+        yyjson_val *val;
+        benchmark_tick_begin();
+        yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+        yyjson_arr_foreach(yyjson_doc_get_root(doc), idx, max, val) {
+            sum += yyjson_get_len(val);
+        }
+        benchmark_tick_end();
+        if (!doc) return 0;
+        yyjson_doc_free(doc);
+        *len = sum;
+    }
+    
+    return benchmark_tick_min();
+}
+
+u64 string_writer_measure_yyjson(const char *json, size_t size, string_escape esc,
+                                 size_t *out_size, int repeat) {
+    benchmark_tick_init();
+    
+    yyjson_doc *doc = yyjson_read(json, size, YYJSON_READ_NOFLAG);
+    if (!doc) return 0;
+    yyjson_write_flag flag = YYJSON_WRITE_NOFLAG;
+    if (esc == STRING_ESCAPE_UNICODE) flag = YYJSON_WRITE_ESCAPE_UNICODE;
+    if (esc == STRING_ESCAPE_SLASHES) flag = YYJSON_WRITE_ESCAPE_SLASHES;
+    
+    for (int i = 0; i < repeat; i++) {
+        benchmark_tick_begin();
+        char *str = yyjson_write(doc, flag, out_size);
+        benchmark_tick_end();
+        if (!str) {
+            yyjson_doc_free(doc);
+            return 0;
+        }
+        free(str);
+    }
+    yyjson_doc_free(doc);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// blob
+
+/* Allocator which counts the bytes held, the size is stored before the block. */
+typedef struct {
+    usize used;
+} blob_counter;
+
+#define BLOB_HDR_SIZE 16
+
+static void *blob_malloc(void *ctx, size_t size) {
+    u8 *ptr = malloc(size + BLOB_HDR_SIZE);
+    if (!ptr) return NULL;
+    memcpy(ptr, &size, sizeof(size_t));
+    ((blob_counter *)ctx)->used += size;
+    return ptr + BLOB_HDR_SIZE;
+}
+
+static void *blob_realloc(void *ctx, void *ptr, size_t old_size, size_t size) {
+    u8 *hdr = realloc((u8 *)ptr - BLOB_HDR_SIZE, size + BLOB_HDR_SIZE);
+    if (!hdr) return NULL;
+    memcpy(hdr, &size, sizeof(size_t));
+    ((blob_counter *)ctx)->used += size - old_size;
+    return hdr + BLOB_HDR_SIZE;
+}
+
+static void blob_free(void *ctx, void *ptr) {
+    size_t size;
+    u8 *hdr = (u8 *)ptr - BLOB_HDR_SIZE;
+    memcpy(&size, hdr, sizeof(size_t));
+    ((blob_counter *)ctx)->used -= size;
+    free(hdr);
+}
+
+u64 blob_measure_yyjson(const char *json, size_t size, bool insitu,
+                        usize *mem, int repeat) {
+    benchmark_tick_init();
+    
+    blob_counter counter = { 0 };
+    yyjson_alc alc = { blob_malloc, blob_realloc, blob_free, &counter };
+    yyjson_read_flag flag = insitu ? YYJSON_READ_INSITU : YYJSON_READ_NOFLAG;
+    char *dat = insitu ? malloc(size + YYJSON_PADDING_SIZE) : NULL;
+    if (insitu && !dat) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        if (insitu) {
+            memcpy(dat, json, size);
+            memset(dat + size, 0, YYJSON_PADDING_SIZE);
+        }
+        benchmark_tick_begin();
+        yyjson_doc *doc = yyjson_read_opts(insitu ? dat : (char *)(void *)json,
+                                           size, flag, &alc, NULL);
+        benchmark_tick_end();
+        if (!doc) {
+            free(dat);
+            return 0;
+        }
+        *mem = counter.used;
+        yyjson_doc_free(doc);
+    }
+    free(dat);
+    
+    return benchmark_tick_min();
+}
+
+
+// -----------------------------------------------------------------------------
+// nested
+
+u64 nested_measure_yyjson(const char *json, size_t size, nested_mode mode,
+                          usize *count, int repeat) {
+    benchmark_tick_init();
+    
+    // the inner document is read in place but never in-situ, the payload is
+    // not followed by the zero padding which YYJSON_READ_INSITU requires
+    bool insitu = (mode == NESTED_INSITU);
+    char *dat = insitu ? malloc(size + YYJSON_PADDING_SIZE) : NULL;
+    if (insitu && !dat) return 0;
+    
+    for (int i = 0; i < repeat; i++) {
+        if (insitu) {
+            memcpy(dat, json, size);
+            memset(dat + size, 0, YYJSON_PADDING_SIZE);
+        }
+        usize num = 0, idx, max;
+        yyjson_val *msg;
+        benchmark_tick_begin();
+        yyjson_doc *doc = yyjson_read_opts(insitu ? dat : (char *)(void *)json, size,
+                                           insitu ? YYJSON_READ_INSITU : YYJSON_READ_NOFLAG,
+                                           NULL, NULL);
+        bool suc = (doc != NULL);
+        yyjson_arr_foreach(yyjson_doc_get_root(doc), idx, max, msg) {
+            yyjson_val *payload = yyjson_obj_get(msg, "payload");
+            const char *str = yyjson_get_str(payload);
+            usize len = yyjson_get_len(payload);
+            char *tmp = NULL;
+            if (str && mode == NESTED_COPY) {
+                tmp = malloc(len + 1);
+                if (tmp) memcpy(tmp, str, len + 1);
+                str = tmp;
+            }
+            yyjson_doc *inner = str ? yyjson_read(str, len, YYJSON_READ_NOFLAG) : NULL;
+            free(tmp);
+            if (!inner) {
+                suc = false;
+                break;
+            }
+            yyjson_doc_free(inner);
+            num++;
+        }
+        benchmark_tick_end();
+        yyjson_doc_free(doc);
+        if (!suc) {
+            free(dat);
+            return 0;
+        }
+        *count = num;
+    }
+    free(dat);
+    
+    return benchmark_tick_min();
+}